@@ -1,7 +1,9 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "LinkedList.h"
+#include "memory.h"
 
 struct Node_t
 {
@@ -18,7 +20,7 @@ struct List_t
 
 Node *llCreateNode(void *data)
 {
-    Node *n = malloc(sizeof(Node));
+    Node *n = memoryAlloc(MEMORY_LIST, sizeof(Node));
     if (!n)
         return NULL;
 
@@ -40,7 +42,7 @@ Node *llNext(Node *node)
 
 List *llCreateEmpty()
 {
-    List *list = malloc(sizeof(List));
+    List *list = memoryAlloc(MEMORY_LIST, sizeof(List));
     if (!list)
         return NULL;
 
@@ -74,11 +76,11 @@ void llFree(List *list)
     while (n)
     {
         nn = n->next;
-        free(n);
+        memoryFree(n);
         n = nn;
     }
 
-    free(list);
+    memoryFree(list);
 }
 
 void llFreeData(List *list)
@@ -89,12 +91,12 @@ void llFreeData(List *list)
     while (n)
     {
         nn = n->next;
-        free(n->data);
-        free(n);
+        memoryFree(n->data);
+        memoryFree(n);
         n = nn;
     }
 
-    free(list);
+    memoryFree(list);
 }
 
 void llInsertFirst(List *list, Node *node)
@@ -138,8 +140,8 @@ void llInsertLast(List *list, Node *node)
         llInsertFirst(list, node);
 }
 
-int llFilter(List *list, int (*test)(void *, void *),
-             void *params, int dryRun, int freeData)
+int llFilter(List *list, LLPredicate test, const void *context, int dryRun,
+             int freeData)
 {
 
     int count = 0;
@@ -151,7 +153,7 @@ int llFilter(List *list, int (*test)(void *, void *),
 
         Node *nn = cn->next;
 
-        if (test(cn->data, params))
+        if (test(cn->data, context))
         {
             count++;
             if (!dryRun)
@@ -161,8 +163,8 @@ int llFilter(List *list, int (*test)(void *, void *),
                 else
                     list->head = nn;
                 if (freeData)
-                    free(cn->data);
-                free(cn);
+                    memoryFree(cn->data);
+                memoryFree(cn);
                 list->length--;
             }
             cn = nn;
@@ -176,3 +178,28 @@ int llFilter(List *list, int (*test)(void *, void *),
 
     return count;
 }
+
+Node *llFind(const List *list, LLPredicate test, const void *context)
+{
+    Node *n = list->head;
+
+    while (n && !test(n->data, context))
+        n = n->next;
+
+    return n;
+}
+
+Node *llFindString(const List *list, const char *string)
+{
+    Node *n = list->head;
+
+    while (n && strcmp(n->data, string) != 0)
+        n = n->next;
+
+    return n;
+}
+
+int llStringEquals(const void *data, const void *context)
+{
+    return strcmp(data, context) == 0;
+}
@@ -13,6 +13,18 @@ typedef struct Node_t Node;
  */
 typedef struct List_t List;
 
+/**
+ * @brief Test on the data of a node. Everything the test needs is passed
+ * through `context`, so that tests are plain functions: reentrant, and
+ * callable from several threads on different lists.
+ *
+ * @param data Data stored in the node.
+ * @param context Context given along with the test.
+ *
+ * @return non-zero if the node passes the test.
+ */
+typedef int (*LLPredicate)(const void *data, const void *context);
+
 /**
  * @brief Creates a new node.
  *
@@ -82,7 +94,8 @@ size_t llLength(const List *list);
 void llFree(List *list);
 
 /**
- * @brief Free a list, and the data stored in the nodes.
+ * @brief Free a list, and the data stored in the nodes, which must have
+ * been allocated with memoryAlloc.
  *
  * @param list List to free.
  */
@@ -122,13 +135,45 @@ void llInsertLast(List *list, Node *node);
  *
  * @param list List to remove the nodes from.
  * @param test Function to test if a node should be removed.
- * @param params Parameters to pass to the test function.
+ * @param context Context passed to the test function.
  * @param dryRun If true, no nodes are actually removed.
  * @param freeData If true, the data of the removed nodes is freed.
  *
  * @return The number of nodes removed.
  */
-int llFilter(List *list, int (*test)(void *, void *),
-			 void *params, int dryRun, int freeData);
+int llFilter(List *list, LLPredicate test, const void *context, int dryRun,
+             int freeData);
+
+/**
+ * @brief Get the first node of a list that passes some test.
+ *
+ * @param list List to search.
+ * @param test Function to test the nodes.
+ * @param context Context passed to the test function.
+ *
+ * @return The first node passing the test, or NULL if none does.
+ */
+Node *llFind(const List *list, LLPredicate test, const void *context);
+
+/**
+ * @brief Get the first node of a list of strings equal to a string. Same
+ * as llFind with llStringEquals, without the call through a pointer.
+ *
+ * @param list List of strings to search.
+ * @param string The string.
+ *
+ * @return The first node holding the string, or NULL if none does.
+ */
+Node *llFindString(const List *list, const char *string);
+
+/**
+ * @brief Test of the nodes holding a string equal to `context`.
+ *
+ * @param data String stored in the node.
+ * @param context The string compared with.
+ *
+ * @return non-zero if the strings are equal.
+ */
+int llStringEquals(const void *data, const void *context);
 
 #endif // !_LINKED_LIST_H_
@@ -0,0 +1,172 @@
+#include "alphabet.h"
+#include "wordle.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+
+#define ALPHABET_ASCII (128)    // Code points looked up in a direct table
+#define ALPHABET_UNKNOWN (0xff) // Index of a letter not in the alphabet
+
+
+struct Alphabet_t {
+    int size;
+    uint32_t letters[ALPHABET_MAX_LETTERS]; // Code point of each index
+    unsigned char ascii[ALPHABET_ASCII];    // Index of each ASCII letter
+};
+
+
+static int find(const Alphabet *alphabet, uint32_t point);
+static void expectNotNull(void *p);
+
+
+Alphabet *alphabetCreate(void)
+{
+    Alphabet *alphabet = memoryAlloc(MEMORY_ALPHABET, sizeof(Alphabet));
+    expectNotNull(alphabet);
+
+    alphabet->size = 0;
+    memset(alphabet->ascii, ALPHABET_UNKNOWN, sizeof(alphabet->ascii));
+
+    return alphabet;
+}
+
+
+void alphabetFree(Alphabet *alphabet)
+{
+    memoryFree(alphabet);
+}
+
+
+int alphabetSize(const Alphabet *alphabet)
+{
+    return alphabet->size;
+}
+
+
+int alphabetAdd(Alphabet *alphabet, const char *word, unsigned char *letters)
+{
+    uint32_t points[WORD_LENGTH];
+
+    if (alphabetDecode(word, points, WORD_LENGTH) != WORD_LENGTH)
+        return 0;
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        int index = find(alphabet, points[i]);
+
+        if (index < 0) {
+            if (alphabet->size == ALPHABET_MAX_LETTERS)
+                return -1;
+            index = alphabet->size++;
+            alphabet->letters[index] = points[i];
+            if (points[i] < ALPHABET_ASCII)
+                alphabet->ascii[points[i]] = (unsigned char)index;
+        }
+
+        letters[i] = (unsigned char)index;
+    }
+
+    return 1;
+}
+
+
+int alphabetEncode(const Alphabet *alphabet, const char *word,
+                   unsigned char *letters)
+{
+    uint32_t points[WORD_LENGTH];
+
+    if (alphabetDecode(word, points, WORD_LENGTH) != WORD_LENGTH)
+        return 0;
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        int index = find(alphabet, points[i]);
+        if (index < 0)
+            return 0;
+        letters[i] = (unsigned char)index;
+    }
+
+    return 1;
+}
+
+
+int alphabetDecode(const char *word, uint32_t *points, int max)
+{
+    const unsigned char *c = (const unsigned char *)word;
+    int count = 0;
+
+    while (*c) {
+        uint32_t point;
+        int extra;
+
+        if (*c < 0x80) {
+            point = *c;
+            extra = 0;
+        } else if ((*c & 0xe0) == 0xc0) {
+            point = *c & 0x1f;
+            extra = 1;
+        } else if ((*c & 0xf0) == 0xe0) {
+            point = *c & 0x0f;
+            extra = 2;
+        } else if ((*c & 0xf8) == 0xf0) {
+            point = *c & 0x07;
+            extra = 3;
+        } else {
+            return -1;
+        }
+        c++;
+
+        for (int k = 0; k < extra; k++, c++) {
+            if ((*c & 0xc0) != 0x80)
+                return -1;
+            point = (point << 6) | (*c & 0x3f);
+        }
+
+        // Overlong forms, surrogates and code points past Unicode
+        static const uint32_t smallest[4] = {0, 0x80, 0x800, 0x10000};
+        if (point < smallest[extra] || point > 0x10ffff
+            || (point >= 0xd800 && point <= 0xdfff))
+            return -1;
+
+        if (count == max)
+            return -1;
+        if (points)
+            points[count] = point;
+        count++;
+    }
+
+    return count;
+}
+
+
+int alphabetWordLength(const char *word)
+{
+    return alphabetDecode(word, NULL, INT_MAX);
+}
+
+
+/**
+ * @brief Get the index of a code point, or -1 if it is not in the alphabet.
+ */
+static int find(const Alphabet *alphabet, uint32_t point)
+{
+    if (point < ALPHABET_ASCII)
+        return alphabet->ascii[point] == ALPHABET_UNKNOWN ? -1 : alphabet->ascii[point];
+
+    // Letters past ASCII are few
+    for (int i = 0; i < alphabet->size; i++)
+        if (alphabet->letters[i] == point)
+            return i;
+
+    return -1;
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
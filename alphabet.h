@@ -0,0 +1,88 @@
+#ifndef ALPHABET_H
+#define ALPHABET_H
+
+#include <stdint.h>
+
+#define ALPHABET_MAX_LETTERS (64) // Distinct letters a dictionary may use
+
+/**
+ * @brief Represents the letters of a dictionary, each mapped to a dense
+ * index in [0, ALPHABET_MAX_LETTERS) in the order they are met.
+ *
+ * Words are read as UTF-8 and stored as WORD_LENGTH letter indices, one
+ * byte each, so that patterns are computed on small integers whatever the
+ * script: a 40-letter French alphabet has the same layout as a-z. Letters
+ * are Unicode code points, so accented letters must be precomposed (NFC).
+ */
+typedef struct Alphabet_t Alphabet;
+
+/**
+ * @brief Creates an empty alphabet.
+ *
+ * @return The created alphabet.
+ */
+Alphabet *alphabetCreate(void);
+
+/**
+ * @brief Frees an alphabet.
+ *
+ * @param alphabet Alphabet to free.
+ */
+void alphabetFree(Alphabet *alphabet);
+
+/**
+ * @brief Get the number of letters of an alphabet.
+ *
+ * @param alphabet The alphabet.
+ *
+ * @return the number of letters.
+ */
+int alphabetSize(const Alphabet *alphabet);
+
+/**
+ * @brief Encodes a word, adding its new letters to the alphabet.
+ *
+ * @param alphabet The alphabet.
+ * @param word UTF-8 word.
+ * @param letters Filled with the WORD_LENGTH letter indices of the word.
+ *
+ * @return 1 if encoded, 0 if the word is not made of WORD_LENGTH valid
+ * UTF-8 letters, -1 if the alphabet has no room for its new letters.
+ */
+int alphabetAdd(Alphabet *alphabet, const char *word, unsigned char *letters);
+
+/**
+ * @brief Encodes a word with the letters already in the alphabet.
+ *
+ * @param alphabet The alphabet.
+ * @param word UTF-8 word.
+ * @param letters Filled with the WORD_LENGTH letter indices of the word.
+ *
+ * @return 1 if encoded, 0 if the word is not made of WORD_LENGTH letters
+ * of the alphabet.
+ */
+int alphabetEncode(const Alphabet *alphabet, const char *word,
+                   unsigned char *letters);
+
+/**
+ * @brief Decodes the code points of a UTF-8 word.
+ *
+ * @param word UTF-8 word.
+ * @param points Filled with the code points, or NULL to only count them.
+ * @param max Capacity of `points`.
+ *
+ * @return the number of code points, or -1 if the word is not valid UTF-8
+ * or has more than `max` code points.
+ */
+int alphabetDecode(const char *word, uint32_t *points, int max);
+
+/**
+ * @brief Counts the letters of a UTF-8 word.
+ *
+ * @param word UTF-8 word.
+ *
+ * @return the number of code points, or -1 if the word is not valid UTF-8.
+ */
+int alphabetWordLength(const char *word);
+
+#endif
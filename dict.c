@@ -4,6 +4,7 @@
 #include <time.h>
 
 #include "dict.h"
+#include "memory.h"
 
 typedef struct Node_t
 {
@@ -40,11 +41,11 @@ static void terminate(char *m)
 
 Dict *dictCreate(int m)
 {
-    Dict *d = malloc(sizeof(Dict));
+    Dict *d = memoryAlloc(MEMORY_DICT, sizeof(Dict));
     if (d == NULL)
         terminate("Dict cannot be created");
 
-    d->array = calloc(m, sizeof(Node *));
+    d->array = memoryCalloc(MEMORY_DICT, m, sizeof(Node *));
     if (d->array == NULL)
         terminate("Dict cannot be created");
 
@@ -61,14 +62,14 @@ void dictFree(Dict *d)
         while (n != NULL)
         {
             nn = n->next;
-            free(n->key);
-            free(n);
+            memoryFree(n->key);
+            memoryFree(n);
             n = nn;
         }
     }
 
-    free(d->array);
-    free(d);
+    memoryFree(d->array);
+    memoryFree(d);
 }
 
 double dictSearch(Dict *d, char *key)
@@ -108,12 +109,12 @@ void dictInsert(Dict *d, char *key, double value)
 
     else
     {
-        Node *newNode = malloc(sizeof(Node));
+        Node *newNode = memoryAlloc(MEMORY_DICT, sizeof(Node));
         if (!newNode)
             terminate("New node cannot be created.");
 
         int len = strlen(key);
-        char *k = malloc((len + 1) * sizeof(char));
+        char *k = memoryAlloc(MEMORY_DICT, (len + 1) * sizeof(char));
         if (!k)
             terminate("New node cannot be created.");
 
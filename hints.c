@@ -0,0 +1,331 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "hints.h"
+#include "solver.h"
+#include "wordle.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+
+#define HINTS_SLICE_MS (20) // Search time between two checks for a new move
+
+
+/**
+ * @brief Suggestion precomputed for one pattern of the current hint.
+ */
+typedef struct
+{
+    int pattern;                 // Pattern code
+    char guess[WORD_BYTES]; // Suggestion after that pattern
+} Speculation;
+
+struct Hints_t {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;  // A move was played, or the thread must stop
+    pthread_cond_t ready; // The hint of the last move is known
+
+    // Shared with the player's thread, under the lock
+    int stop;
+    char (*guesses)[WORD_BYTES];       // Moves played so far
+    char (*patterns)[WORD_LENGTH + 1];
+    int moves;
+    int capacity;
+    int known;                         // 1 when `hint` follows the last move
+    char hint[WORD_BYTES];
+
+    // Owned by the background thread
+    Solver *solver;  // State after the first `applied` moves
+    int applied;
+    int planned[HINTS_SPECULATED]; // Most likely patterns of the hint
+    int nbPlanned;
+    Speculation speculations[HINTS_SPECULATED];
+    int nbSpeculations;             // Patterns of `planned` already done
+};
+
+
+static void *hintsLoop(void *arg);
+static int followMove(Hints *hints, const char *guess, const char *pattern,
+                      char *hint);
+static void planSpeculations(Hints *hints, char *hint);
+static int speculate(Hints *hints, char *hint, int pattern, char *guess);
+static int interrupted(Hints *hints);
+static void publish(Hints *hints, const char *hint);
+static void expectNotNull(void *p);
+
+
+Hints *hintsStart(char *answers_file, char *guesses_file)
+{
+    Hints *hints = memoryAlloc(MEMORY_HINTS, sizeof(Hints));
+    expectNotNull(hints);
+
+    hints->stop = 0;
+    hints->capacity = 8;
+    hints->guesses = memoryAlloc(MEMORY_HINTS, hints->capacity * sizeof(*hints->guesses));
+    hints->patterns = memoryAlloc(MEMORY_HINTS, hints->capacity * sizeof(*hints->patterns));
+    expectNotNull(hints->guesses);
+    expectNotNull(hints->patterns);
+    hints->moves = 0;
+    hints->known = 0;
+    hints->hint[0] = '\0';
+
+    hints->solver = solverStart(answers_file, guesses_file);
+    hints->applied = 0;
+    hints->nbPlanned = 0;
+    hints->nbSpeculations = 0;
+
+    pthread_mutex_init(&hints->lock, NULL);
+    pthread_cond_init(&hints->wake, NULL);
+    pthread_cond_init(&hints->ready, NULL);
+
+    if (pthread_create(&hints->thread, NULL, hintsLoop, hints) != 0) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+
+    return hints;
+}
+
+
+void hintsPlay(Hints *hints, char *guess, char *pattern)
+{
+    pthread_mutex_lock(&hints->lock);
+
+    if (hints->moves == hints->capacity) {
+        hints->capacity *= 2;
+        hints->guesses = memoryRealloc(MEMORY_HINTS, hints->guesses,
+                                       hints->capacity * sizeof(*hints->guesses));
+        hints->patterns = memoryRealloc(MEMORY_HINTS, hints->patterns,
+                                        hints->capacity * sizeof(*hints->patterns));
+        expectNotNull(hints->guesses);
+        expectNotNull(hints->patterns);
+    }
+
+    strncpy(hints->guesses[hints->moves], guess, WORD_BYTES - 1);
+    hints->guesses[hints->moves][WORD_BYTES - 1] = '\0';
+    strncpy(hints->patterns[hints->moves], pattern, WORD_LENGTH);
+    hints->patterns[hints->moves][WORD_LENGTH] = '\0';
+    hints->moves++;
+    hints->known = 0;
+
+    pthread_cond_signal(&hints->wake);
+    pthread_mutex_unlock(&hints->lock);
+}
+
+
+void hintsGet(Hints *hints, char *guess)
+{
+    pthread_mutex_lock(&hints->lock);
+    while (!hints->known)
+        pthread_cond_wait(&hints->ready, &hints->lock);
+    strcpy(guess, hints->hint);
+    pthread_mutex_unlock(&hints->lock);
+}
+
+
+void hintsFree(Hints *hints)
+{
+    pthread_mutex_lock(&hints->lock);
+    hints->stop = 1;
+    pthread_cond_signal(&hints->wake);
+    pthread_mutex_unlock(&hints->lock);
+
+    pthread_join(hints->thread, NULL);
+
+    pthread_mutex_destroy(&hints->lock);
+    pthread_cond_destroy(&hints->wake);
+    pthread_cond_destroy(&hints->ready);
+    solverFree(hints->solver);
+    memoryFree(hints->guesses);
+    memoryFree(hints->patterns);
+    memoryFree(hints);
+}
+
+
+/**
+ * @brief Background thread: follows the moves, searches the hint of the
+ * current state by short slices, then speculates on the likely patterns
+ * of the hint. Every step checks for a new move or a stop in between.
+ */
+static void *hintsLoop(void *arg)
+{
+    Hints *hints = arg;
+    char guess[WORD_BYTES], pattern[WORD_LENGTH + 1];
+    char hint[WORD_BYTES] = {0};
+    int searching = 1; // 0 once the hint of the current state is known
+
+    pthread_mutex_lock(&hints->lock);
+
+    while (!hints->stop) {
+        if (hints->applied < hints->moves) {
+            strcpy(guess, hints->guesses[hints->applied]);
+            strcpy(pattern, hints->patterns[hints->applied]);
+            hints->applied++;
+            pthread_mutex_unlock(&hints->lock);
+
+            searching = !followMove(hints, guess, pattern, hint);
+
+            pthread_mutex_lock(&hints->lock);
+            if (!searching && hints->applied == hints->moves)
+                publish(hints, hint);
+            continue;
+        }
+
+        if (searching) {
+            pthread_mutex_unlock(&hints->lock);
+
+            SolverProgress progress;
+            solverBestGuessWithin(hints->solver, hint, HINTS_SLICE_MS, &progress);
+            searching = !progress.complete;
+            if (!searching)
+                planSpeculations(hints, hint);
+
+            pthread_mutex_lock(&hints->lock);
+            if (!searching && hints->applied == hints->moves)
+                publish(hints, hint);
+            continue;
+        }
+
+        if (hints->nbSpeculations < hints->nbPlanned) {
+            pthread_mutex_unlock(&hints->lock);
+
+            Speculation *s = &hints->speculations[hints->nbSpeculations];
+            s->pattern = hints->planned[hints->nbSpeculations];
+            if (speculate(hints, hint, s->pattern, s->guess))
+                hints->nbSpeculations++;
+
+            pthread_mutex_lock(&hints->lock);
+            continue;
+        }
+
+        pthread_cond_wait(&hints->wake, &hints->lock);
+    }
+
+    pthread_mutex_unlock(&hints->lock);
+
+    return NULL;
+}
+
+
+/**
+ * @brief Plays a move on the thread's solver.
+ *
+ * @return 1 if the hint of the new state is already known, stored in `hint`.
+ */
+static int followMove(Hints *hints, const char *guess, const char *pattern,
+                      char *hint)
+{
+    int code = wordlePatternFromString(pattern);
+    int found = 0;
+
+    if (strcmp(guess, hint) == 0) {
+        for (int k = 0; k < hints->nbSpeculations; k++) {
+            if (hints->speculations[k].pattern == code) {
+                strcpy(hint, hints->speculations[k].guess);
+                found = 1;
+                break;
+            }
+        }
+    }
+
+    solverUpdate(hints->solver, (char *)guess, (char *)pattern);
+    hints->nbPlanned = 0;
+    hints->nbSpeculations = 0;
+
+    if (solverGetNbAnswers(hints->solver) == 0) {
+        hint[0] = '\0';
+        return 1;
+    }
+
+    if (found)
+        planSpeculations(hints, hint);
+
+    return found;
+}
+
+
+/**
+ * @brief Chooses the patterns of the hint to speculate on: those of the
+ * largest buckets, the most likely to be seen.
+ */
+static void planSpeculations(Hints *hints, char *hint)
+{
+    int histogram[PATTERN_COUNT];
+
+    solverPatternCounts(hints->solver, hint, histogram);
+    histogram[PATTERN_SOLVED] = 0;
+
+    hints->nbPlanned = 0;
+    hints->nbSpeculations = 0;
+
+    while (hints->nbPlanned < HINTS_SPECULATED) {
+        int best = 0;
+        for (int p = 1; p < PATTERN_COUNT; p++)
+            if (histogram[p] > histogram[best])
+                best = p;
+
+        if (histogram[best] == 0)
+            break;
+
+        hints->planned[hints->nbPlanned++] = best;
+        histogram[best] = 0;
+    }
+}
+
+
+/**
+ * @brief Computes the suggestion after `hint` gets a pattern, on a clone
+ * of the thread's solver.
+ *
+ * @return 1 if done, 0 if interrupted by a move or a stop.
+ */
+static int speculate(Hints *hints, char *hint, int pattern, char *guess)
+{
+    char string[WORD_LENGTH + 1];
+    SolverProgress progress;
+
+    Solver *clone = solverClone(hints->solver);
+    wordlePatternToString(pattern, string);
+    solverUpdate(clone, hint, string);
+
+    do
+        solverBestGuessWithin(clone, guess, HINTS_SLICE_MS, &progress);
+    while (!progress.complete && !interrupted(hints));
+
+    solverFree(clone);
+
+    return progress.complete;
+}
+
+
+static int interrupted(Hints *hints)
+{
+    pthread_mutex_lock(&hints->lock);
+    int interrupted = hints->stop || hints->applied < hints->moves;
+    pthread_mutex_unlock(&hints->lock);
+
+    return interrupted;
+}
+
+
+/**
+ * @brief Makes a hint available to hintsGet. Must be called with the lock.
+ */
+static void publish(Hints *hints, const char *hint)
+{
+    strcpy(hints->hint, hint);
+    hints->known = 1;
+    pthread_cond_broadcast(&hints->ready);
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
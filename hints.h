@@ -0,0 +1,56 @@
+#ifndef HINTS_H
+#define HINTS_H
+
+#define HINTS_SPECULATED (8) // Patterns of the hint whose replies are precomputed
+
+/**
+ * @brief Represents a background thread computing the solver's suggestion
+ * for a game played by someone else.
+ *
+ * While the player thinks, the thread finds the best guess of the current
+ * state, then precomputes the suggestions following the HINTS_SPECULATED
+ * most likely patterns of that guess, so that a hint is usually ready
+ * when asked for, even right after a move.
+ */
+typedef struct Hints_t Hints;
+
+/**
+ * @brief Starts the background thread on a new game.
+ *
+ * @param answers_file Path to the file containing
+ * the possible answers.
+ * @param guesses_file Path to the file containing
+ * the accepted words.
+ *
+ * @return The created hints.
+ */
+Hints *hintsStart(char *answers_file, char *guesses_file);
+
+/**
+ * @brief Tells the background thread about a move of the player. The work
+ * on the previous state is abandoned.
+ *
+ * @param hints The hints.
+ * @param guess the guess played.
+ * @param pattern the pattern obtained.
+ */
+void hintsPlay(Hints *hints, char *guess, char *pattern);
+
+/**
+ * @brief Get the solver's suggestion for the current state, waiting for it
+ * if it is not computed yet.
+ *
+ * @param hints The hints.
+ * @param guess buffer to store the guess ("" if no answer is possible).
+ */
+void hintsGet(Hints *hints, char *guess);
+
+/**
+ * @brief Cancels the background work, waits for the thread and frees the
+ * hints.
+ *
+ * @param hints Hints to free.
+ */
+void hintsFree(Hints *hints);
+
+#endif
@@ -0,0 +1,249 @@
+#include "kernel.h"
+#include "wordle.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNEL_X86 (1) // The vector variants can be compiled
+#endif
+
+
+typedef void (*PatternsFunction)(const unsigned char *guess,
+                                 const unsigned char *columns, size_t stride,
+                                 int n, unsigned char *codes);
+
+static const char *const variantNames[KERNEL_VARIANTS] = {
+    "scalar", "sse4.2", "avx2", "avx512"
+};
+
+static pthread_once_t chosen = PTHREAD_ONCE_INIT;
+static KernelVariant variant = KERNEL_SCALAR;
+static int forced = 0; // 1 if the variant was named by WORDLE_KERNEL
+static PatternsFunction patterns = NULL;
+static long computed = 0; // Patterns computed, updated atomically
+
+
+static void choose(void);
+static int supported(KernelVariant v);
+static void patternsScalar(const unsigned char *guess,
+                           const unsigned char *columns, size_t stride, int n,
+                           unsigned char *codes);
+#ifdef KERNEL_X86
+static void patternsSse42(const unsigned char *guess,
+                          const unsigned char *columns, size_t stride, int n,
+                          unsigned char *codes);
+static void patternsAvx2(const unsigned char *guess,
+                         const unsigned char *columns, size_t stride, int n,
+                         unsigned char *codes);
+static void patternsAvx512(const unsigned char *guess,
+                           const unsigned char *columns, size_t stride, int n,
+                           unsigned char *codes);
+#endif
+
+
+void kernelPatterns(const unsigned char *guess, const unsigned char *columns,
+                    size_t stride, int n, unsigned char *codes)
+{
+    pthread_once(&chosen, choose);
+    patterns(guess, columns, stride, n, codes);
+    __atomic_fetch_add(&computed, n, __ATOMIC_RELAXED);
+}
+
+
+KernelVariant kernelVariant(void)
+{
+    pthread_once(&chosen, choose);
+    return variant;
+}
+
+
+const char *kernelName(KernelVariant v)
+{
+    return variantNames[v];
+}
+
+
+void kernelReport(FILE *out)
+{
+    KernelVariant v = kernelVariant();
+
+    fprintf(out, "Noyau des motifs : %s (%s), %ld motifs calculés\n",
+            kernelName(v), forced ? "imposé par WORDLE_KERNEL" : "choisi d'après le processeur",
+            __atomic_load_n(&computed, __ATOMIC_RELAXED));
+}
+
+
+/**
+ * @brief Picks the variant named by WORDLE_KERNEL, or else the fastest one
+ * the processor supports.
+ */
+static void choose(void)
+{
+    const char *name = getenv("WORDLE_KERNEL");
+
+    if (name && *name) {
+        int v = 0;
+        while (v < KERNEL_VARIANTS && strcmp(name, variantNames[v]) != 0)
+            v++;
+
+        if (v == KERNEL_VARIANTS) {
+            fprintf(stderr, "Le noyau %s n'existe pas (scalar, sse4.2, avx2 ou avx512).\n", name);
+            exit(EXIT_FAILURE);
+        }
+        if (!supported((KernelVariant)v)) {
+            fprintf(stderr, "Le noyau %s n'est pas pris en charge par ce processeur.\n", name);
+            exit(EXIT_FAILURE);
+        }
+
+        variant = (KernelVariant)v;
+        forced = 1;
+    }
+    else {
+        variant = KERNEL_AVX512;
+        while (!supported(variant))
+            variant--;
+    }
+
+    switch (variant) {
+#ifdef KERNEL_X86
+    case KERNEL_SSE42:
+        patterns = patternsSse42;
+        break;
+    case KERNEL_AVX2:
+        patterns = patternsAvx2;
+        break;
+    case KERNEL_AVX512:
+        patterns = patternsAvx512;
+        break;
+#endif
+    default:
+        patterns = patternsScalar;
+    }
+}
+
+
+static int supported(KernelVariant v)
+{
+#ifdef KERNEL_X86
+    __builtin_cpu_init();
+
+    switch (v) {
+    case KERNEL_SSE42:
+        return __builtin_cpu_supports("sse4.2");
+    case KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2");
+    case KERNEL_AVX512:
+        return __builtin_cpu_supports("avx512bw");
+    default:
+        return 1;
+    }
+#else
+    return v == KERNEL_SCALAR;
+#endif
+}
+
+
+/**
+ * @brief The reference: one answer at a time.
+ */
+static void patternsScalar(const unsigned char *guess,
+                           const unsigned char *columns, size_t stride, int n,
+                           unsigned char *codes)
+{
+    unsigned char answer[WORD_LENGTH];
+
+    for (int a = 0; a < n; a++) {
+        for (int i = 0; i < WORD_LENGTH; i++)
+            answer[i] = columns[i * stride + a];
+        codes[a] = (unsigned char)wordlePatternLetters(guess, answer);
+    }
+}
+
+
+#ifdef KERNEL_X86
+
+typedef unsigned char Vector16 __attribute__((vector_size(16)));
+typedef unsigned char Vector32 __attribute__((vector_size(32)));
+typedef unsigned char Vector64 __attribute__((vector_size(64)));
+
+/**
+ * @brief Codes of one block of answers, in lanes of bytes where masks are
+ * 0xff or 0. Position i is yellow when the answer letters not matched by a
+ * green, equal to guess[i], outnumber the non-green positions of the guess
+ * before i with the same letter: yellows are given from left to right.
+ * Every digit is at most 162, and the code at most 242, so bytes do.
+ */
+#define PATTERN_BLOCK(V, guess, letters, code)                              \
+    do {                                                                    \
+        static const unsigned char pow3[WORD_LENGTH] = {1, 3, 9, 27, 81};   \
+        V green[WORD_LENGTH];                                               \
+        int i, j;                                                           \
+                                                                            \
+        code = (V){0};                                                      \
+        for (i = 0; i < WORD_LENGTH; i++) {                                 \
+            green[i] = (V)(letters[i] == guess[i]);                         \
+            code += green[i] & (unsigned char)(2 * pow3[i]);                \
+        }                                                                   \
+                                                                            \
+        for (i = 0; i < WORD_LENGTH; i++) {                                 \
+            V left = (V){0}, before = (V){0};                               \
+            for (j = 0; j < WORD_LENGTH; j++)                               \
+                left -= (V)(letters[j] == guess[i]) & ~green[j];            \
+            for (j = 0; j < i; j++)                                         \
+                if (guess[j] == guess[i])                                   \
+                    before -= ~green[j];                                    \
+            code += ~green[i] & (V)(left > before) & pow3[i];               \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief Codes of every answer, by blocks as wide as V: the last one is
+ * padded with zeros, whose codes are dropped.
+ */
+#define PATTERNS(V, guess, columns, stride, n, codes)                       \
+    do {                                                                    \
+        V letters[WORD_LENGTH], code;                                       \
+                                                                            \
+        for (int a = 0; a < n; a += (int)sizeof(V)) {                       \
+            int m = n - a < (int)sizeof(V) ? n - a : (int)sizeof(V);        \
+            for (int i = 0; i < WORD_LENGTH; i++) {                         \
+                letters[i] = (V){0};                                        \
+                memcpy(&letters[i], columns + i * stride + a, m);           \
+            }                                                               \
+            PATTERN_BLOCK(V, guess, letters, code);                         \
+            memcpy(codes + a, &code, m);                                    \
+        }                                                                   \
+    } while (0)
+
+
+__attribute__((target("sse4.2")))
+static void patternsSse42(const unsigned char *guess,
+                          const unsigned char *columns, size_t stride, int n,
+                          unsigned char *codes)
+{
+    PATTERNS(Vector16, guess, columns, stride, n, codes);
+}
+
+
+__attribute__((target("avx2")))
+static void patternsAvx2(const unsigned char *guess,
+                         const unsigned char *columns, size_t stride, int n,
+                         unsigned char *codes)
+{
+    PATTERNS(Vector32, guess, columns, stride, n, codes);
+}
+
+
+__attribute__((target("avx512f,avx512bw")))
+static void patternsAvx512(const unsigned char *guess,
+                           const unsigned char *columns, size_t stride, int n,
+                           unsigned char *codes)
+{
+    PATTERNS(Vector64, guess, columns, stride, n, codes);
+}
+
+#endif
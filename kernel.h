@@ -0,0 +1,62 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief Instruction sets the pattern kernel is compiled for, from the
+ * slowest to the fastest.
+ */
+typedef enum
+{
+    KERNEL_SCALAR,
+    KERNEL_SSE42,
+    KERNEL_AVX2,
+    KERNEL_AVX512,
+    KERNEL_VARIANTS // Number of variants
+} KernelVariant;
+
+/**
+ * @brief Computes the pattern codes of a guess against many answers.
+ *
+ * Every variant is compiled into the executable, the right one being
+ * picked the first time a kernel is used: the fastest the processor
+ * supports, unless the WORDLE_KERNEL environment variable names another
+ * (scalar, sse4.2, avx2 or avx512). The answers are given by columns,
+ * the i-th letters of all of them being contiguous, so that the vector
+ * variants compare a guess letter with 16, 32 or 64 answers at once.
+ *
+ * @param guess WORD_LENGTH letter indices of the word tried.
+ * @param columns WORD_LENGTH columns of letter indices, one per position.
+ * @param stride Distance between two columns.
+ * @param n Number of answers.
+ * @param codes Filled with the n pattern codes.
+ */
+void kernelPatterns(const unsigned char *guess, const unsigned char *columns,
+                    size_t stride, int n, unsigned char *codes);
+
+/**
+ * @brief Get the variant of the kernel, choosing it if not done yet.
+ *
+ * @return the variant.
+ */
+KernelVariant kernelVariant(void);
+
+/**
+ * @brief Get the name of a variant, as given to WORDLE_KERNEL.
+ *
+ * @param variant The variant.
+ *
+ * @return the name.
+ */
+const char *kernelName(KernelVariant variant);
+
+/**
+ * @brief Prints the variant chosen and how many patterns it computed.
+ *
+ * @param out File to print to.
+ */
+void kernelReport(FILE *out);
+
+#endif
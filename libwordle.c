@@ -0,0 +1,265 @@
+#include "libwordle.h"
+#include "partition.h"
+#include "solver.h"
+#include "scheduler.h"
+#include "metric.h"
+#include "wordle.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// The public constants must follow the internal ones
+typedef char CheckWordBytes[LW_WORD_BYTES == WORD_BYTES ? 1 : -1];
+typedef char CheckMetrics[(int)LW_METRIC_BUCKETS == (int)METRIC_BUCKETS ? 1 : -1];
+
+struct LwContext_t
+{
+    Partition *engine; // Owned by the solver
+    Solver *solver;    // State without any move, cloned by each history
+    Scheduler *scheduler;
+};
+
+/**
+ * @brief Search of the best guess of one history.
+ */
+typedef struct Search_t
+{
+    Solver *solver;
+    LwAdvice *advice;
+} Search;
+
+static const char *const statusMessages[] = {
+    "success",
+    "invalid argument",
+    "a word file could not be read",
+    "a word file holds an invalid word or too many letters",
+    "the answers file is empty",
+    "the word is not an accepted guess",
+    "the pattern is not 5 symbols among _ * o",
+    "no possible answer gives this history",
+    "a move follows the solved pattern"
+};
+
+
+static Solver *applyHistory(LwContext *context, const LwHistory *history,
+                            LwAdvice *advice);
+static void searchHistory(Scheduler *scheduler, void *arg);
+static void expectNotNull(void *p);
+
+
+void lwOptionsDefault(LwOptions *options)
+{
+    options->threads = 1;
+    options->metric = LW_METRIC_EXPECTED;
+    options->approximate = 0;
+    options->sample = 0;
+    options->seed = 1;
+}
+
+
+LwStatus lwOpen(const char *answers_file, const char *guesses_file,
+                const LwOptions *options, LwContext **context)
+{
+    LwOptions defaults;
+
+    if (context == NULL)
+        return LW_ERROR_ARGUMENT;
+    *context = NULL;
+
+    if (options == NULL) {
+        lwOptionsDefault(&defaults);
+        options = &defaults;
+    }
+    if (answers_file == NULL || guesses_file == NULL || options->threads < 1
+        || options->metric < LW_METRIC_EXPECTED || options->metric > LW_METRIC_BUCKETS
+        || options->sample < 0 || options->sample == 1)
+        return LW_ERROR_ARGUMENT;
+
+    PartitionError error;
+    Partition *engine = partitionLoad((char *)answers_file, (char *)guesses_file, &error);
+
+    if (engine == NULL)
+        return error.status == PARTITION_FILE_ERROR ? LW_ERROR_FILE : LW_ERROR_WORD_LIST;
+
+    if (partitionNbAnswers(engine) == 0) {
+        partitionFree(engine);
+        return LW_ERROR_EMPTY;
+    }
+
+    LwContext *c = memoryAlloc(MEMORY_LIBRARY, sizeof(LwContext));
+    expectNotNull(c);
+
+    c->engine = engine;
+    c->solver = solverStartEngine(engine);
+    solverSetMetric(c->solver, (Metric)options->metric);
+    solverSetApproximate(c->solver, options->approximate);
+    solverSetSampling(c->solver, options->sample, options->seed);
+    c->scheduler = schedulerCreate(options->threads);
+
+    *context = c;
+    return LW_OK;
+}
+
+
+void lwClose(LwContext *context)
+{
+    if (context == NULL)
+        return;
+
+    schedulerFree(context->scheduler);
+    solverFree(context->solver);
+    memoryFree(context);
+}
+
+
+const char *lwStatusMessage(LwStatus status)
+{
+    if (status < LW_OK || status > LW_ERROR_SOLVED)
+        return "unknown status";
+
+    return statusMessages[status];
+}
+
+
+int lwNbAnswers(const LwContext *context)
+{
+    return partitionNbAnswers(context->engine);
+}
+
+
+int lwNbGuesses(const LwContext *context)
+{
+    return partitionNbGuesses(context->engine);
+}
+
+
+LwStatus lwScoreHistories(LwContext *context, const LwHistory *histories,
+                          int count, LwAdvice *advice)
+{
+    if (context == NULL || count < 0 || (count > 0 && (histories == NULL || advice == NULL)))
+        return LW_ERROR_ARGUMENT;
+
+    for (int h = 0; h < count; h++)
+        if (histories[h].count < 0 || (histories[h].count > 0 && histories[h].moves == NULL))
+            return LW_ERROR_ARGUMENT;
+
+    Search *searches = memoryAlloc(MEMORY_LIBRARY, (count > 0 ? count : 1) * sizeof(Search));
+    expectNotNull(searches);
+
+    // Clones of the root must be made by this thread, then any worker
+    // can search and free them
+    for (int h = 0; h < count; h++) {
+        searches[h].solver = applyHistory(context, &histories[h], &advice[h]);
+        searches[h].advice = &advice[h];
+
+        if (searches[h].solver)
+            schedulerSpawn(context->scheduler, searchHistory, &searches[h]);
+    }
+
+    schedulerWait(context->scheduler);
+    memoryFree(searches);
+
+    return LW_OK;
+}
+
+
+LwStatus lwValidateGuesses(const LwContext *context, const char *const *guesses,
+                           int count, LwStatus *statuses)
+{
+    if (context == NULL || count < 0 || (count > 0 && (guesses == NULL || statuses == NULL)))
+        return LW_ERROR_ARGUMENT;
+
+    for (int i = 0; i < count; i++)
+        statuses[i] = guesses[i] && partitionFindGuess(context->engine, guesses[i]) >= 0
+                    ? LW_OK : LW_ERROR_GUESS;
+
+    return LW_OK;
+}
+
+
+/**
+ * @brief Checks the moves of a history and plays them on a clone of the
+ * root solver.
+ *
+ * @return the clone, left to search the next guess, or NULL if the history
+ * is rejected or solved, its advice being complete.
+ */
+static Solver *applyHistory(LwContext *context, const LwHistory *history,
+                            LwAdvice *advice)
+{
+    advice->status = LW_OK;
+    advice->move = -1;
+    advice->remaining = 0;
+    advice->guess[0] = '\0';
+    advice->score = 0.;
+
+    int solved = 0;
+    for (int m = 0; m < history->count && advice->status == LW_OK; m++) {
+        const LwMove *move = &history->moves[m];
+
+        if (solved)
+            advice->status = LW_ERROR_SOLVED;
+        else if (move->guess == NULL || partitionFindGuess(context->engine, move->guess) < 0)
+            advice->status = LW_ERROR_GUESS;
+        else if (move->pattern == NULL || wordlePatternFromString(move->pattern) < 0)
+            advice->status = LW_ERROR_PATTERN;
+        else
+            solved = wordlePatternFromString(move->pattern) == PATTERN_SOLVED;
+
+        if (advice->status != LW_OK)
+            advice->move = m;
+    }
+    if (advice->status != LW_OK)
+        return NULL;
+
+    // The moves before the solved one must leave its guess as an answer
+    int played = history->count - solved;
+    Solver *solver = solverClone(context->solver);
+    for (int m = 0; m < played; m++) {
+        solverUpdate(solver, (char *)history->moves[m].guess,
+                     (char *)history->moves[m].pattern);
+
+        if (solverGetNbAnswers(solver) == 0) {
+            advice->status = LW_ERROR_NO_ANSWER;
+            advice->move = m;
+            solverFree(solver);
+            return NULL;
+        }
+    }
+
+    if (solved) {
+        int histogram[PATTERN_COUNT];
+        solverPatternCounts(solver, (char *)history->moves[played].guess, histogram);
+        if (histogram[PATTERN_SOLVED] == 0) {
+            advice->status = LW_ERROR_NO_ANSWER;
+            advice->move = played;
+        }
+        solverFree(solver);
+        return NULL;
+    }
+
+    advice->remaining = solverGetNbAnswers(solver);
+    return solver;
+}
+
+
+static void searchHistory(Scheduler *scheduler, void *arg)
+{
+    Search *search = arg;
+
+    (void)scheduler;
+
+    search->advice->score = solverBestGuess(search->solver, search->advice->guess);
+    solverFree(search->solver);
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
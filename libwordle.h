@@ -0,0 +1,194 @@
+#ifndef LIBWORDLE_H
+#define LIBWORDLE_H
+
+/*
+ * Embeddable interface of the solver, built as libwordle.a and libwordle.so.
+ * This header is self-contained and stable: it exposes no internal type,
+ * contexts are opaque, and errors are returned as status codes instead of
+ * ending the process. Only running out of memory still exits.
+ */
+
+#if defined(__GNUC__)
+#define LW_API __attribute__((visibility("default")))
+#else
+#define LW_API
+#endif
+
+#define LW_WORD_BYTES (21) // Buffer of a UTF-8 word of 5 letters and its '\0'
+
+/**
+ * @brief Represents word lists loaded once, and the threads scoring guesses
+ * on them. A context must not be used by two threads at once, but distinct
+ * contexts are independent.
+ */
+typedef struct LwContext_t LwContext;
+
+/**
+ * @brief Result of a call, or of one item of a batch.
+ */
+typedef enum
+{
+    LW_OK,
+    LW_ERROR_ARGUMENT,  // NULL pointer, negative count or invalid option
+    LW_ERROR_FILE,      // A word file could not be opened or read
+    LW_ERROR_WORD_LIST, // A word file holds a word that is not 5 letters,
+                        // or more than 64 distinct letters
+    LW_ERROR_EMPTY,     // The answers file holds no word
+    LW_ERROR_GUESS,     // The word is not an accepted guess
+    LW_ERROR_PATTERN,   // The pattern is not 5 symbols among _ * o
+    LW_ERROR_NO_ANSWER, // No possible answer gives this history
+    LW_ERROR_SOLVED     // A move follows the pattern ooooo
+} LwStatus;
+
+/**
+ * @brief Criteria scoring a guess, the higher the better.
+ */
+typedef enum
+{
+    LW_METRIC_EXPECTED, // Answers eliminated on average
+    LW_METRIC_ENTROPY,  // Shannon entropy of the patterns, in bits
+    LW_METRIC_LARGEST,  // Answers eliminated in the worst case
+    LW_METRIC_BUCKETS   // Number of distinct patterns
+} LwMetric;
+
+/**
+ * @brief Settings of a context.
+ */
+typedef struct LwOptions_t
+{
+    int threads;          // Histories scored at once (at least 1)
+    LwMetric metric;      // Score of the guesses
+    int approximate;      // 1 to only score the guesses ranked best by
+                          // letter frequencies
+    int sample;           // Answers the expected and entropy scores are
+                          // estimated on (0 for exact scores)
+    unsigned long seed;   // Seed of the samples
+} LwOptions;
+
+/**
+ * @brief One guess played and the pattern it gave, each symbol being '_'
+ * (letter absent), '*' (present elsewhere) or 'o' (well placed).
+ */
+typedef struct LwMove_t
+{
+    const char *guess;
+    const char *pattern;
+} LwMove;
+
+/**
+ * @brief The moves of one game, in the order they were played.
+ */
+typedef struct LwHistory_t
+{
+    const LwMove *moves;
+    int count;
+} LwHistory;
+
+/**
+ * @brief The solver's reply to a history.
+ */
+typedef struct LwAdvice_t
+{
+    LwStatus status;           // LW_OK, or why the history was rejected
+    int move;                  // Index of the rejected move (-1 if none)
+    int remaining;             // Possible answers left (0 once solved)
+    char guess[LW_WORD_BYTES]; // Best next guess ("" if none)
+    double score;              // Score of `guess`
+} LwAdvice;
+
+/**
+ * @brief Fills options with the defaults: one thread, the expected metric,
+ * exhaustive and exact scores, seed 1.
+ *
+ * @param options The options.
+ */
+LW_API void lwOptionsDefault(LwOptions *options);
+
+/**
+ * @brief Loads the word files, one UTF-8 word per line.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param options Settings (NULL for the defaults).
+ * @param context Set to the new context, or to NULL on error.
+ *
+ * @return LW_OK, LW_ERROR_ARGUMENT, LW_ERROR_FILE, LW_ERROR_WORD_LIST or
+ * LW_ERROR_EMPTY.
+ */
+LW_API LwStatus lwOpen(const char *answers_file, const char *guesses_file,
+                       const LwOptions *options, LwContext **context);
+
+/**
+ * @brief Frees a context and stops its threads.
+ *
+ * @param context The context (NULL does nothing).
+ */
+LW_API void lwClose(LwContext *context);
+
+/**
+ * @brief Get a short English description of a status.
+ *
+ * @param status The status.
+ *
+ * @return the description, a static string.
+ */
+LW_API const char *lwStatusMessage(LwStatus status);
+
+/**
+ * @brief Get the number of possible answers of the word lists.
+ *
+ * @param context The context.
+ *
+ * @return the number of answers.
+ */
+LW_API int lwNbAnswers(const LwContext *context);
+
+/**
+ * @brief Get the number of accepted guesses of the word lists.
+ *
+ * @param context The context.
+ *
+ * @return the number of guesses.
+ */
+LW_API int lwNbGuesses(const LwContext *context);
+
+/**
+ * @brief Gives the solver's next guess for many games at once. The moves of
+ * every history are checked and applied first, then the best guesses of
+ * the valid histories are searched in parallel, each on its own copy of
+ * the word lists' state.
+ *
+ * A history fails alone: its advice gets the status and the index of its
+ * first rejected move (LW_ERROR_GUESS, LW_ERROR_PATTERN or
+ * LW_ERROR_SOLVED), or LW_ERROR_NO_ANSWER if its moves contradict every
+ * answer. A history ending with the pattern ooooo is solved if its last
+ * guess is one of the answers left by the moves before: LW_OK, no answer
+ * remaining and no guess.
+ *
+ * @param context The context.
+ * @param histories The games.
+ * @param count Number of games.
+ * @param advice Array of count replies, in the order of histories.
+ *
+ * @return LW_ERROR_ARGUMENT if an argument is invalid (advice is then left
+ * untouched), LW_OK otherwise, even if some histories were rejected.
+ */
+LW_API LwStatus lwScoreHistories(LwContext *context, const LwHistory *histories,
+                                 int count, LwAdvice *advice);
+
+/**
+ * @brief Checks many words against the accepted guesses.
+ *
+ * @param context The context.
+ * @param guesses The words.
+ * @param count Number of words.
+ * @param statuses Array of count results: LW_OK for an accepted guess,
+ * LW_ERROR_GUESS otherwise.
+ *
+ * @return LW_ERROR_ARGUMENT if an argument is invalid, LW_OK otherwise.
+ */
+LW_API LwStatus lwValidateGuesses(const LwContext *context,
+                                  const char *const *guesses, int count,
+                                  LwStatus *statuses);
+
+#endif
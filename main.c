@@ -1,39 +1,253 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
 #include <time.h>
+#include <unistd.h>
+#include <errno.h>
 
 #include "wordle.h"
 #include "solver.h"
+#include "tournament.h"
+#include "memory.h"
+#include "hints.h"
+#include "transposition.h"
+#include "optimize.h"
+#include "kernel.h"
+#include "tree.h"
+#include "alphabet.h"
+#include "trace.h"
+#include "wordlists.h"
+#include "libwordle.h"
 
 /* If equal to 1 some debut messages are printed on the screen */
 
 #define DEBUG 1
 
+#define BATCH_LINES (1024) // Histories scored at once by the batch mode
+
 /**
  * @brief Structure to store the args of the program.
  */
 struct _args
 {
     bool use_solver;
+    bool adversarial;
+    bool tournament;
+    bool whatif;
+    bool stats;
+    bool hints;
+    bool assist;
+    bool optimize;
+    bool batch;
+    bool approximate;
     char *answers_file;
     char *guesses_file;
     char *answer;
     char *first_guess;
+    char *cache_file;
+    char *tree_file;
+    char *trace_file;
+    char *replay_file;
+    long time_budget_ms;
+    int boards;
+    int threads;
+    int shards;
+    int top;
+    long table_mb;
+    SolverStrategy strategy;
+    Metric metric;
+    int sample;
+    unsigned long seed;
 };
 
 /**
  * @brief Play a game of wordle.
  *
  * @param solverp Set to true if the solver should be used.
+ * @param adversarial Set to true for a game without fixed hidden word.
  * @param answers_file Path to the file containing the possible answers.
  * @param guesses_file Path to the file containing the accepted words.
  * @param answer The answer to the game (NULL if it must be selected at random).
  * @param first_guess The first guess of the game (only for solver).
+ * @param time_budget_ms Time budget of each solver move in milliseconds
+ *                       (negative for no limit).
+ * @param hints Set to true to let the player ask for the solver's
+ *              suggestion by typing "?" (not for solver).
+ * @param strategy Criterion of the solver's guesses (only for solver).
+ * @param metric Score of the solver's guesses (only for solver).
+ * @param sample Number of answers the solver's scores are estimated on
+ *               (0 to count them exactly, only for solver).
+ * @param seed Seed of the samples.
+ * @param approximate Set to true to only score the guesses ranked best by
+ *                    letter frequencies (only for solver).
+ * @param table_mb Size of the table remembering the bounds proven by the
+ *                 minimax strategy in MiB (0 for none).
+ * @param tree_file Decision tree giving the solver's guesses, written by the
+ *                  optimize mode (NULL for none). The solver searches the
+ *                  guesses the tree does not give.
+ * @param trace_file Trace the game is appended to (NULL for none).
+ */
+static void play(bool solverp, bool adversarial, char *answers_file,
+                 char *guesses_file, char *answer, char *first_guess,
+                 long time_budget_ms, bool hints, SolverStrategy strategy,
+                 Metric metric, int sample, unsigned long seed,
+                 bool approximate, long table_mb, char *tree_file,
+                 char *trace_file);
+
+/**
+ * @brief Play several boards of wordle at once (Quordle, Octordle...): each
+ * guess is played on every unsolved board, each board hiding its own word.
+ *
+ * @param solverp Set to true if the solver should be used.
+ * @param boards Number of boards.
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param first_guess The first guess of the game (only for solver).
+ * @param time_budget_ms Time budget of each solver move in milliseconds
+ *                       (negative for no limit).
+ * @param metric Score of the solver's guesses (only for solver).
+ * @param approximate Set to true to only score the guesses ranked best by
+ *                    letter frequencies (only for solver).
+ */
+static void play_boards(bool solverp, int boards, char *answers_file,
+                        char *guesses_file, char *first_guess,
+                        long time_budget_ms, Metric metric, bool approximate);
+
+/**
+ * @brief Play the solver against every possible answer and print the
+ * distribution of the number of guesses.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param first_guess The first guess of every game (NULL to let the solver
+ *                    choose), or several ones separated by commas to play
+ *                    one tournament per first guess.
+ * @param threads Number of worker threads (of each shard).
+ * @param shards Number of processes the answers are dealt to.
+ * @param table_mb Size of the transposition table shared by the tournaments
+ *                 in MiB (0 for none).
+ * @param strategy Criterion of the solver's guesses.
+ * @param metric Score of the solver's guesses.
+ * @param sample Number of answers the solver's scores are estimated on (0
+ *               to count them exactly).
+ * @param seed Seed of the samples.
+ * @param approximate Set to true to only score the guesses ranked best by
+ *                    letter frequencies.
+ *
+ * An approximate or sampled solver also prints how often an exhaustive
+ * search would have chosen another guess.
+ */
+static void play_tournament(char *answers_file, char *guesses_file,
+                            char *first_guess, int threads, int shards,
+                            long table_mb, SolverStrategy strategy,
+                            Metric metric, int sample, unsigned long seed,
+                            bool approximate);
+
+/**
+ * @brief Print the solver's next guess for every pattern a first guess may
+ * get.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param first_guess The guess to analyse.
+ * @param threads Number of worker threads.
+ * @param strategy Criterion of the solver's guesses.
+ * @param metric Score of the solver's guesses.
+ */
+static void play_whatif(char *answers_file, char *guesses_file,
+                        char *first_guess, int threads,
+                        SolverStrategy strategy, Metric metric);
+
+/**
+ * @brief Help with games played elsewhere: read each guess made and the
+ * pattern seen, and print the best next guesses. A new game starts once
+ * one is won. The word files are reloaded when they change, the game in
+ * progress going on with the old words.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param top Number of guesses suggested.
+ * @param metric Score of the guesses suggested.
+ */
+static void play_assist(char *answers_file, char *guesses_file, int top,
+                        Metric metric);
+
+/**
+ * @brief Compute the strategy needing the fewest guesses in total over
+ * every possible answer, and print its distribution of the number of
+ * guesses.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param first_guess Forced first guess (NULL to search the best one).
+ * @param threads Number of worker threads (of each shard).
+ * @param shards Number of processes the search is spread over.
+ * @param table_mb Size of the table memoizing the costs in MiB.
+ * @param cache_file File keeping the results across runs (NULL for none).
+ * @param tree_file File the decision tree is written to (NULL for none).
+ */
+static void play_optimize(char *answers_file, char *guesses_file,
+                          char *first_guess, int threads, int shards,
+                          long table_mb, char *cache_file, char *tree_file);
+
+/**
+ * @brief Replay the games of a trace through the solver as fast as
+ * possible: print how many of the solver's recorded guesses it would not
+ * choose anymore, and how its time to choose them changed.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param replay_file The trace, written by --trace.
+ * @param table_mb Size of the table remembering the bounds proven by the
+ *                 minimax strategy in MiB (0 for none).
+ */
+static void play_replay(char *answers_file, char *guesses_file,
+                        char *replay_file, long table_mb);
+
+/**
+ * @brief Read games from the standard input, one per line as the words
+ * played each followed by its pattern, and print the solver's next guess
+ * for each of them. The games are scored by batches through libwordle, as
+ * any program embedding the library would.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param threads Number of games scored at once.
+ * @param metric Score of the solver's guesses.
+ * @param sample Number of answers the scores are estimated on (0 to count
+ *               them exactly).
+ * @param seed Seed of the samples.
+ * @param approximate Set to true to only score the guesses ranked best by
+ *                    letter frequencies.
+ */
+static void play_batch(char *answers_file, char *guesses_file, int threads,
+                       Metric metric, int sample, unsigned long seed,
+                       bool approximate);
+
+/**
+ * @brief Score a batch of games read by play_batch and print the replies.
+ *
+ * @param context The library context.
+ * @param lines The games, split in place into their words and patterns.
+ * @param count Number of games.
+ */
+static void score_batch(LwContext *context, char **lines, int count);
+
+/**
+ * @brief Get the time elapsed since `start` in microseconds.
+ */
+static long elapsed_us(const struct timespec *start);
+
+/**
+ * @brief Print the best guesses of the solver's current state.
+ *
+ * @param solver The solver.
+ * @param top Number of guesses to print.
  */
-static void play(bool solverp, char *answers_file, char *guesses_file,
-                 char *answer, char *first_guess);
+static void print_suggestions(Solver *solver, int top);
 
 /**
  * @brief Parse the arguments of the program.
@@ -50,8 +264,12 @@ static struct _args parse_args(int argc, char **argv);
  */
 static void usage();
 
-static void play(bool solverp, char *answers_file, char *guesses_file,
-                 char *answer, char *first_guess)
+static void play(bool solverp, bool adversarial, char *answers_file,
+                 char *guesses_file, char *answer, char *first_guess,
+                 long time_budget_ms, bool hints, SolverStrategy strategy,
+                 Metric metric, int sample, unsigned long seed,
+                 bool approximate, long table_mb, char *tree_file,
+                 char *trace_file)
 {
     printf("-------------------------------------\n");
     printf("Bienvenue au Wordle. \nVous avez 6 essais "
@@ -60,37 +278,106 @@ static void play(bool solverp, char *answers_file, char *guesses_file,
            "à une autre place.\n o : la lettre est la bonne place.\n");
     printf("-------------------------------------\n");
 
-    Wordle *game = wordleStart(answers_file, guesses_file, answer);
+    Wordle *game;
+    if (adversarial)
+        game = wordleStartAdversarial(answers_file, guesses_file);
+    else
+        game = wordleStart(answers_file, guesses_file, answer);
 
-    if (DEBUG)
+    if (DEBUG && !adversarial)
         printf("DEBUG MODE: Hidden word: %s\n", wordleGetTrueWord(game));
 
     Solver *solver;
+    Partition *engine = NULL; // Owned by the solver
+    Transposition *table = NULL;
     if (solverp)
-        solver = solverStart(answers_file, guesses_file);
+    {
+        engine = partitionCreate(answers_file, guesses_file);
+        solver = solverStartEngine(engine);
+        solverSetStrategy(solver, strategy);
+        solverSetMetric(solver, metric);
+        solverSetSampling(solver, sample, seed);
+        solverSetApproximate(solver, approximate);
+        solverSetIncremental(solver, 1);
+
+        // Bounds proven for the sets of answers met during the game
+        if (strategy == SOLVER_MINIMAX && table_mb > 0)
+        {
+            table = transpositionCreate((size_t)table_mb << 20);
+            solverSetTransposition(solver, table);
+        }
+    }
+
+    // Followed while the patterns seen are in the tree
+    DecisionTree *tree = NULL;
+    DecisionNode *node = NULL;
+    if (solverp && tree_file)
+    {
+        tree = decisionTreeLoad(tree_file, engine);
+        node = decisionTreeRoot(tree);
+    }
+
+    // Worked out in the background while the player thinks
+    Hints *hinter = NULL;
+    if (hints && !solverp)
+    {
+        hinter = hintsStart(answers_file, guesses_file);
+        printf("Tapez ? pour obtenir un indice.\n");
+    }
+
+    memorySetPhase(MEMORY_PLAY);
+
+    Trace *trace = NULL;
+    TraceGame record = {.strategy = strategy, .metric = metric,
+                        .approximate = approximate, .sample = sample,
+                        .seed = seed};
+    if (trace_file)
+        trace = traceAppend(trace_file, answers_file, guesses_file);
 
     // Game Loop
-    char guess[10];
+    char guess[32];
     char *pattern = NULL;
-    char solverguess[6];
-    solverguess[5] = '\0';
+    char solverguess[WORD_BYTES] = {0};
     int nbTrials = 0;
 
     do
     {
         if (pattern)
-            free(pattern);
+            memoryFree(pattern);
 
         printf("Essai %d : ", nbTrials + 1);
+        TraceMove *move = &record.moves[nbTrials];
+        move->flags = 0;
+        move->latencyUs = 0;
 
         if (solverp)
         {
             if (nbTrials == 0 && first_guess)
-                strncpy(solverguess, first_guess, 5);
+                strcpy(solverguess, first_guess);
+            else if (node)
+                strcpy(solverguess, decisionNodeGuess(node));
             else
-                solverBestGuess(solver, solverguess);
+            {
+                SolverProgress progress;
+                struct timespec start;
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                solverBestGuessWithin(solver, solverguess, time_budget_ms, &progress);
+                move->latencyUs = elapsed_us(&start);
+                move->flags = TRACE_SOLVER | (progress.complete ? TRACE_COMPLETE : 0);
+                if (DEBUG && !progress.complete)
+                    printf("DEBUG MODE: (guesses scored: %d/%d)\n",
+                           progress.scanned, progress.total);
+            }
 
             printf("%s\n", solverguess);
+
+            SolverSample estimate;
+            solverGetSample(solver, &estimate);
+            if (estimate.size > 0)
+                printf("(score estimé sur %d mots : %.2f, intervalle [%.2f, %.2f], "
+                       "%d essais comptés exactement)\n",
+                       estimate.size, estimate.estimate, estimate.low,
+                       estimate.high, estimate.candidates);
             pattern = wordleCheckGuess(game, solverguess);
 
             if (!pattern)
@@ -105,7 +392,17 @@ static void play(bool solverp, char *answers_file, char *guesses_file,
         {
             while (1)
             {
-                scanf("%s", guess);
+                if (scanf("%31s", guess) != 1)
+                    exit(EXIT_FAILURE);
+
+                if (hinter && strcmp(guess, "?") == 0)
+                {
+                    hintsGet(hinter, solverguess);
+                    printf("Indice : %s\n", solverguess);
+                    printf("Essai %d : ", nbTrials + 1);
+                    continue;
+                }
+
                 pattern = wordleCheckGuess(game, guess);
                 if (!pattern)
                 {
@@ -114,6 +411,8 @@ static void play(bool solverp, char *answers_file, char *guesses_file,
                 }
                 else
                 {
+                    if (hinter)
+                        hintsPlay(hinter, guess, pattern);
                     nbTrials++;
                     break;
                 }
@@ -123,11 +422,19 @@ static void play(bool solverp, char *answers_file, char *guesses_file,
         printf("          %s\n", pattern);
         printf("\n");
 
+        strcpy(move->guess, solverp ? solverguess : guess);
+        move->pattern = wordlePatternFromString(pattern);
+
         if (solverp)
         {
             solverUpdate(solver, solverguess, pattern);
             if (DEBUG)
                 printf("DEBUG MODE: (remaining answers: %d)\n", solverGetNbAnswers(solver));
+            // The tree no longer applies once another guess is played
+            if (node && strcmp(solverguess, decisionNodeGuess(node)) != 0)
+                node = NULL;
+            if (node)
+                node = decisionNodeChild(node, pattern);
         }
     } while ((strcmp(pattern, "ooooo") != 0) && (nbTrials < 6));
 
@@ -140,124 +447,1184 @@ static void play(bool solverp, char *answers_file, char *guesses_file,
         printf("Partie perdue ! Le mot était : %s\n", wordleGetTrueWord(game));
     }
 
-    free(pattern);
+    if (trace)
+    {
+        strcpy(record.answer, wordleGetTrueWord(game));
+        record.nbMoves = nbTrials;
+        traceWrite(trace, &record);
+    }
+
+    memorySetPhase(MEMORY_CLEANUP);
+    if (trace)
+        traceClose(trace);
+    if (hinter)
+        hintsFree(hinter);
+    memoryFree(pattern);
     wordleFree(game);
     if (solverp)
         solverFree(solver);
+    if (table)
+        transpositionFree(table);
+    if (tree)
+        decisionTreeFree(tree);
 }
 
-static struct _args parse_args(int argc, char **argv)
+static void play_boards(bool solverp, int boards, char *answers_file,
+                        char *guesses_file, char *first_guess,
+                        long time_budget_ms, Metric metric, bool approximate)
 {
-    struct _args args = {false, NULL, NULL, NULL, NULL};
+    int maxTrials = 5 + boards;
 
-    if (argc == 1)
+    printf("-------------------------------------\n");
+    printf("Bienvenue au Wordle à %d grilles. \nVous avez %d essais "
+           "pour trouver les mots cachés.\n _ : La lettre n'est "
+           "pas dans le mot.\n * : la lettre est présente mais "
+           "à une autre place.\n o : la lettre est la bonne place.\n",
+           boards, maxTrials);
+    printf("-------------------------------------\n");
+
+    Wordle **games = memoryAlloc(MEMORY_MAIN, boards * sizeof(Wordle *));
+    char **patterns = memoryCalloc(MEMORY_MAIN, boards, sizeof(char *));
+    bool *solved = memoryCalloc(MEMORY_MAIN, boards, sizeof(bool));
+    if (!games || !patterns || !solved)
     {
-        usage();
-        exit(EXIT_SUCCESS);
+        perror("Impossible de lancer le jeu:");
+        exit(EXIT_FAILURE);
     }
 
-    int i;
-    for (i = 1; argc - i > 1; i++)
+    for (int b = 0; b < boards; b++)
     {
-        if (strcmp(argv[i], "--mode") == 0)
+        games[b] = wordleStart(answers_file, guesses_file, NULL);
+        if (DEBUG)
+            printf("DEBUG MODE: Hidden word %d: %s\n", b + 1, wordleGetTrueWord(games[b]));
+    }
+
+    Solver *solver;
+    if (solverp)
+    {
+        solver = solverStartBoards(answers_file, guesses_file, boards);
+        solverSetMetric(solver, metric);
+        solverSetApproximate(solver, approximate);
+        solverSetIncremental(solver, 1);
+    }
+
+    memorySetPhase(MEMORY_PLAY);
+
+    // Game Loop
+    char guess[32];
+    int nbTrials = 0;
+    int nbSolved = 0;
+
+    while (nbSolved < boards && nbTrials < maxTrials)
+    {
+        printf("Essai %d : ", nbTrials + 1);
+
+        while (1)
         {
-            if (strcmp(argv[++i], "solver") == 0)
-            {
-                args.use_solver = true;
-            }
-            else if (strcmp(argv[i], "human") == 0)
+            if (solverp)
             {
-                args.use_solver = false;
+                if (nbTrials == 0 && first_guess)
+                    strcpy(guess, first_guess);
+                else
+                    solverBestGuessWithin(solver, guess, time_budget_ms, NULL);
+                printf("%s\n", guess);
             }
-            else
+            else if (scanf("%31s", guess) != 1)
+                exit(EXIT_FAILURE);
+
+            // Every board shares the same accepted words
+            int b = 0;
+            while (solved[b])
+                b++;
+            patterns[b] = wordleCheckGuess(games[b], guess);
+            if (patterns[b])
+                break;
+
+            if (solverp)
             {
-                fprintf(stderr, "Invalid mode: %s.\n", argv[i]);
-                usage();
+                printf("Le premier mot choisi n'existe pas.\n");
                 exit(EXIT_FAILURE);
             }
+            printf("Ce mot est invalide ou n'existe pas.\n");
+            printf("Essai %d : ", nbTrials + 1);
         }
+        nbTrials++;
 
-        else if (strcmp(argv[i], "--answers-file") == 0)
-        {
-            args.answers_file = argv[++i];
-        }
-
-        else if (strcmp(argv[i], "--guesses-file") == 0)
+        for (int b = 0; b < boards; b++)
         {
-            args.guesses_file = argv[++i];
+            if (solved[b])
+                continue;
+            if (!patterns[b])
+                patterns[b] = wordleCheckGuess(games[b], guess);
+            printf("  grille %d : %s\n", b + 1, patterns[b]);
         }
+        printf("\n");
 
-        else if (strcmp(argv[i], "--answer") == 0)
+        if (solverp)
         {
-            args.answer = argv[++i];
+            solverUpdateBoards(solver, guess, patterns);
+            if (DEBUG)
+                printf("DEBUG MODE: (remaining answers: %d)\n", solverGetNbAnswers(solver));
         }
 
-        else if (strcmp(argv[i], "--first-guess") == 0)
+        for (int b = 0; b < boards; b++)
         {
-            args.first_guess = argv[++i];
-
-            if (strlen(args.first_guess) != 5)
+            if (!solved[b] && strcmp(patterns[b], "ooooo") == 0)
             {
-                fprintf(stderr, "Invalid first guess: %s. Should contain 5 letters.\n", args.first_guess);
-                usage();
-                exit(EXIT_FAILURE);
+                solved[b] = true;
+                nbSolved++;
             }
+            memoryFree(patterns[b]);
+            patterns[b] = NULL;
         }
+    }
 
-        else
+    if (nbSolved == boards)
+    {
+        printf("Partie gagnée ! Les %d mots ont été trouvés en %d essais.\n", boards, nbTrials);
+    }
+    else
+    {
+        printf("Partie perdue ! %d mots sur %d ont été trouvés. Les mots étaient :", nbSolved, boards);
+        for (int b = 0; b < boards; b++)
+            printf(" %s", wordleGetTrueWord(games[b]));
+        printf("\n");
+    }
+
+    memorySetPhase(MEMORY_CLEANUP);
+    for (int b = 0; b < boards; b++)
+        wordleFree(games[b]);
+    memoryFree(games);
+    memoryFree(patterns);
+    memoryFree(solved);
+    if (solverp)
+        solverFree(solver);
+}
+
+static void play_tournament(char *answers_file, char *guesses_file,
+                            char *first_guess, int threads, int shards,
+                            long table_mb, SolverStrategy strategy,
+                            Metric metric, int sample, unsigned long seed,
+                            bool approximate)
+{
+    // The shards read the same tables, mapped once for all of them
+    Partition *engine = partitionCreate(answers_file, guesses_file);
+    partitionBuildIndex(engine);
+    if (shards > 1)
+        partitionMapShared(engine);
+
+    // Every opener is checked before the first tournament starts
+    char *next = first_guess;
+    char guess[WORD_BYTES];
+    while (next)
+    {
+        size_t length = strcspn(next, ",");
+        memcpy(guess, next, length);
+        guess[length] = '\0';
+        if (partitionFindGuess(engine, guess) < 0)
         {
-            fprintf(stderr, "Invalid argument: %s.\n", argv[i]);
-            usage();
+            fprintf(stderr, "Le premier mot choisi n'existe pas.\n");
             exit(EXIT_FAILURE);
         }
+        next = next[length] ? next + length + 1 : NULL;
     }
 
-    if (i != argc)
+    Solver *solver = solverStartEngine(engine);
+    solverSetStrategy(solver, strategy);
+    solverSetMetric(solver, metric);
+    solverSetSampling(solver, sample, seed);
+    solverSetApproximate(solver, approximate);
+
+    // States reached again, within a tournament or by the next ones
+    Transposition *table = NULL;
+    if (table_mb > 0)
     {
-        fprintf(stderr, "Invalid arguments.\n");
-        usage();
-        exit(EXIT_FAILURE);
+        if (shards > 1)
+            table = transpositionCreateShared((size_t)table_mb << 20);
+        else
+            table = transpositionCreate((size_t)table_mb << 20);
+        solverSetTransposition(solver, table);
     }
 
-    return args;
+    memorySetPhase(MEMORY_PLAY);
+
+    next = first_guess;
+    do
+    {
+        char *opener = NULL;
+        if (next)
+        {
+            size_t length = strcspn(next, ",");
+            memcpy(guess, next, length);
+            guess[length] = '\0';
+            opener = guess;
+            next = strchr(next, ',');
+            if (next)
+                next++;
+        }
+
+        TournamentResult result = tournamentRunShards(solver, opener, threads,
+                                                      shards);
+
+        int solved = result.games - result.failures;
+        int lost = result.failures;
+        for (int k = 7; k <= TOURNAMENT_MAX_GUESSES; k++)
+            lost += result.counts[k];
+
+        if (opener)
+            printf("Tournoi sur %d mots en commençant par %s (%d threads) :\n",
+                   result.games, opener, threads);
+        else
+            printf("Tournoi sur %d mots (%d threads) :\n", result.games, threads);
+        for (int k = 1; k <= TOURNAMENT_MAX_GUESSES; k++)
+            if (result.counts[k] > 0)
+                printf("  %2d essais : %d\n", k, result.counts[k]);
+        if (solved > 0)
+            printf("Moyenne : %.4f essais par mot trouvé.\n", (double)result.guesses / solved);
+        printf("Parties perdues (plus de 6 essais) : %d\n", lost);
+        if (result.decisions > 0)
+            printf("Choix approchés différents de la recherche exhaustive : %d/%d (%.2f %%)\n"
+                   "Temps de choix : %.1f ms approché, %.1f ms exhaustif\n",
+                   result.mismatches, result.decisions,
+                   100. * result.mismatches / result.decisions,
+                   result.approxUs / 1000., result.exhaustiveUs / 1000.);
+    } while (next);
+
+    if (DEBUG && table)
+    {
+        TranspositionStats stats = transpositionStats(table);
+        printf("DEBUG MODE: (table: %ld trouvés, %ld absents, %ld évincés)\n",
+               stats.hits, stats.misses, stats.evictions);
+    }
+
+    memorySetPhase(MEMORY_CLEANUP);
+    solverFree(solver);
+    if (table)
+        transpositionFree(table);
 }
 
-static void usage()
+static void play_whatif(char *answers_file, char *guesses_file,
+                        char *first_guess, int threads,
+                        SolverStrategy strategy, Metric metric)
 {
-    fprintf(stderr, "Usage: ./wordle [--mode solver|human]"
-                    "[--answers-file answers_file]"
-                    "[--guesses-file guesses_file]"
-                    "[--answer answer]"
-                    "[--first-guess first_guess]\n"
-                    "--mode: solver or human\n"
-                    "--answers-file: file containing the list of possible answers.\n"
-                    "--guesses-file: file containing the list of accepted words.\n"
-                    "--answer: set the hidden word.\n"
-                    "--first-guess: set the first guess (only for the solver mode).\n");
+    Partition *engine = partitionCreate(answers_file, guesses_file);
+    if (partitionFindGuess(engine, first_guess) < 0)
+    {
+        fprintf(stderr, "Le premier mot choisi n'existe pas.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Solver *solver = solverStartEngine(engine);
+    solverSetStrategy(solver, strategy);
+    solverSetMetric(solver, metric);
+    WhatIfReply replies[PATTERN_COUNT];
+    char pattern[WORD_LENGTH + 1];
+
+    memorySetPhase(MEMORY_PLAY);
+    tournamentWhatIf(solver, first_guess, threads, replies);
+
+    printf("Réponses du solveur après %s (%d mots possibles) :\n",
+           first_guess, solverGetNbAnswers(solver));
+    for (int p = 0; p < PATTERN_COUNT; p++)
+    {
+        if (replies[p].remaining == 0)
+            continue;
+
+        wordlePatternToString(p, pattern);
+        if (p == PATTERN_SOLVED)
+            printf("  %s : mot trouvé\n", pattern);
+        else
+            printf("  %s : %4d mots possibles, essai suivant %s (score %.2f)\n",
+                   pattern, replies[p].remaining, replies[p].guess,
+                   replies[p].score);
+    }
+
+    memorySetPhase(MEMORY_CLEANUP);
+    solverFree(solver);
 }
 
-int main(int argc, char **argv)
+static void play_assist(char *answers_file, char *guesses_file, int top,
+                        Metric metric)
 {
-    struct _args args = parse_args(argc, argv);
+    printf("-------------------------------------\n");
+    printf("Assistant Wordle. \nEntrez chaque mot joué suivi du motif "
+           "obtenu (ex. : roate _*o__).\n _ : La lettre n'est "
+           "pas dans le mot.\n * : la lettre est présente mais "
+           "à une autre place.\n o : la lettre est la bonne place.\n");
+    printf("-------------------------------------\n");
 
-    if (args.answers_file == NULL)
+    WordLists *lists = wordListsOpen(answers_file, guesses_file);
+    Solver *solver = solverStartEngine(wordListsSnapshot(lists));
+    solverSetMetric(solver, metric);
+    solverSetIncremental(solver, 1);
+
+    memorySetPhase(MEMORY_PLAY);
+
+    char guess[32];
+    char pattern[10];
+    int nbTrials = 0;
+    PartitionChanges changes;
+
+    print_suggestions(solver, top);
+
+    while (1)
     {
-        fprintf(stderr, "Missing answers file.\n");
-        usage();
-        exit(EXIT_FAILURE);
+        if (wordListsRefresh(lists, &changes))
+            printf("Listes de mots rechargées (réponses : +%d -%d, mots "
+                   "acceptés : +%d -%d), utilisées dès la prochaine partie.\n",
+                   changes.addedAnswers, changes.removedAnswers,
+                   changes.addedGuesses, changes.removedGuesses);
+
+        printf("Essai %d : ", nbTrials + 1);
+        if (scanf("%31s %9s", guess, pattern) != 2)
+            break;
+
+        int code = wordlePatternFromString(pattern);
+        if (alphabetWordLength(guess) != WORD_LENGTH || code < 0)
+        {
+            printf("Entrez un mot de %d lettres puis son motif.\n", WORD_LENGTH);
+            continue;
+        }
+
+        if (code == PATTERN_SOLVED)
+        {
+            printf("Partie gagnée en %d essais !\n", nbTrials + 1);
+            printf("-------------------------------------\n");
+            printf("Nouvelle partie.\n");
+
+            solverFree(solver);
+            solver = solverStartEngine(wordListsSnapshot(lists));
+            solverSetMetric(solver, metric);
+            solverSetIncremental(solver, 1);
+            nbTrials = 0;
+            print_suggestions(solver, top);
+            continue;
+        }
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        // A pattern leaving no possible answer is a typo, the move is undone
+        int snapshot = solverSnapshot(solver);
+        solverUpdate(solver, guess, pattern);
+        if (solverGetNbAnswers(solver) == 0)
+        {
+            solverRestore(solver, snapshot);
+            printf("Aucun mot possible avec ce motif, vérifiez votre saisie.\n");
+            continue;
+        }
+        nbTrials++;
+
+        print_suggestions(solver, top);
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (DEBUG)
+            printf("DEBUG MODE: (réponse en %.1f ms)\n",
+                   (end.tv_sec - start.tv_sec) * 1e3
+                   + (end.tv_nsec - start.tv_nsec) / 1e6);
     }
 
-    if (args.guesses_file == NULL)
+    memorySetPhase(MEMORY_CLEANUP);
+    solverFree(solver);
+    wordListsClose(lists);
+}
+
+static void play_replay(char *answers_file, char *guesses_file,
+                        char *replay_file, long table_mb)
+{
+    Trace *trace = traceOpen(replay_file, answers_file, guesses_file);
+
+    // Cloned for each game, which shares the engine
+    Solver *base = solverStart(answers_file, guesses_file);
+
+    memorySetPhase(MEMORY_PLAY);
+
+    TraceGame record;
+    char guess[WORD_BYTES];
+    char pattern[WORD_LENGTH + 1];
+    int games = 0;
+    long decisions = 0, compared = 0, mismatches = 0;
+    long recordedUs = 0, replayedUs = 0;
+    long worstUs = 0;
+    int worstGame = 0, worstMove = 0;
+
+    while (traceRead(trace, &record))
     {
-        fprintf(stderr, "Missing guesses file.\n");
-        usage();
-        exit(EXIT_FAILURE);
-    }
+        games++;
 
-    srand(time(NULL));
+        Solver *solver = solverClone(base);
+        solverSetStrategy(solver, record.strategy);
+        solverSetMetric(solver, record.metric);
+        solverSetSampling(solver, record.sample, record.seed);
+        solverSetApproximate(solver, record.approximate);
+        solverSetIncremental(solver, 1);
+
+        Transposition *table = NULL;
+        if (record.strategy == SOLVER_MINIMAX && table_mb > 0)
+        {
+            table = transpositionCreate((size_t)table_mb << 20);
+            solverSetTransposition(solver, table);
+        }
+
+        for (int m = 0; m < record.nbMoves; m++)
+        {
+            TraceMove *move = &record.moves[m];
+
+            if (move->flags & TRACE_SOLVER)
+            {
+                struct timespec start;
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                solverBestGuess(solver, guess);
+                long us = elapsed_us(&start);
+
+                decisions++;
+                recordedUs += move->latencyUs;
+                replayedUs += us;
+                if (us - move->latencyUs > worstUs)
+                {
+                    worstUs = us - move->latencyUs;
+                    worstGame = games;
+                    worstMove = m + 1;
+                }
+
+                // A search cut by the time budget may have chosen otherwise
+                if (move->flags & TRACE_COMPLETE)
+                {
+                    compared++;
+                    if (strcmp(guess, move->guess) != 0)
+                    {
+                        mismatches++;
+                        if (DEBUG)
+                            printf("DEBUG MODE: (partie %d, essai %d : %s enregistré, %s rejoué)\n",
+                                   games, m + 1, move->guess, guess);
+                    }
+                }
+            }
 
-    play(args.use_solver, args.answers_file, args.guesses_file,
-         args.answer, args.first_guess);
+            wordlePatternToString(move->pattern, pattern);
+            solverUpdate(solver, move->guess, pattern);
+        }
+
+        solverFree(solver);
+        if (table)
+            transpositionFree(table);
+    }
+
+    printf("Rejeu de %d parties (%ld choix du solveur) :\n", games, decisions);
+    printf("Choix différents de l'enregistrement : %ld/%ld\n", mismatches, compared);
+    printf("Temps de choix : %.1f ms enregistrés, %.1f ms rejoués",
+           recordedUs / 1000., replayedUs / 1000.);
+    if (recordedUs > 0)
+        printf(" (%+.1f %%)", 100. * (replayedUs - recordedUs) / recordedUs);
+    printf("\n");
+    if (worstUs > 0)
+        printf("Plus forte hausse : %+.1f ms (partie %d, essai %d)\n",
+               worstUs / 1000., worstGame, worstMove);
+
+    memorySetPhase(MEMORY_CLEANUP);
+    solverFree(base);
+    traceClose(trace);
+}
+
+static void play_batch(char *answers_file, char *guesses_file, int threads,
+                       Metric metric, int sample, unsigned long seed,
+                       bool approximate)
+{
+    LwOptions options;
+    lwOptionsDefault(&options);
+    options.threads = threads;
+    options.metric = (LwMetric)metric;
+    options.approximate = approximate;
+    options.sample = sample;
+    options.seed = seed;
+
+    LwContext *context;
+    LwStatus status = lwOpen(answers_file, guesses_file, &options, &context);
+    if (status != LW_OK)
+    {
+        fprintf(stderr, "Cannot load the word lists: %s.\n", lwStatusMessage(status));
+        exit(EXIT_FAILURE);
+    }
+
+    memorySetPhase(MEMORY_PLAY);
+
+    char *lines[BATCH_LINES];
+    size_t sizes[BATCH_LINES] = {0};
+    int count = 0;
+
+    for (int i = 0; i < BATCH_LINES; i++)
+        lines[i] = NULL;
+
+    while (getline(&lines[count], &sizes[count], stdin) >= 0)
+    {
+        if (++count == BATCH_LINES)
+        {
+            score_batch(context, lines, count);
+            count = 0;
+        }
+    }
+    score_batch(context, lines, count);
+
+    memorySetPhase(MEMORY_CLEANUP);
+
+    for (int i = 0; i < BATCH_LINES; i++)
+        free(lines[i]);
+    lwClose(context);
+}
+
+static void score_batch(LwContext *context, char **lines, int count)
+{
+    LwHistory histories[BATCH_LINES];
+    LwAdvice advice[BATCH_LINES];
+    int moves = 0;
+
+    // Every word of a line is a guess or a pattern, so a line has fewer
+    // moves than half its length
+    for (int i = 0; i < count; i++)
+        moves += strlen(lines[i]) / 2 + 1;
+
+    LwMove *all = memoryAlloc(MEMORY_MAIN, moves * sizeof(LwMove));
+    if (all == NULL)
+    {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+
+    LwMove *move = all;
+    for (int i = 0; i < count; i++)
+    {
+        histories[i].moves = move;
+        histories[i].count = 0;
+
+        for (char *word = strtok(lines[i], " \t\r\n"); word;
+             word = strtok(NULL, " \t\r\n"))
+        {
+            // An odd word is a guess, its pattern being NULL until read
+            if (histories[i].count == 0 || move[-1].pattern)
+            {
+                move->guess = word;
+                move->pattern = NULL;
+                move++;
+                histories[i].count++;
+            }
+            else
+                move[-1].pattern = word;
+        }
+    }
+
+    lwScoreHistories(context, histories, count, advice);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (advice[i].status != LW_OK)
+            printf("error\t%d\t%s\n", advice[i].move + 1,
+                   lwStatusMessage(advice[i].status));
+        else if (advice[i].guess[0] == '\0')
+            printf("solved\n");
+        else
+            printf("ok\t%s\t%d\t%.4f\n", advice[i].guess,
+                   advice[i].remaining, advice[i].score);
+    }
+    fflush(stdout);
+
+    memoryFree(all);
+}
+
+static long elapsed_us(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec) * 1000000L
+           + (now.tv_nsec - start->tv_nsec) / 1000;
+}
+
+static void print_suggestions(Solver *solver, int top)
+{
+    int remaining = solverGetNbAnswers(solver);
+    char best[WORD_BYTES] = {0};
+
+    if (remaining == 1)
+    {
+        solverBestGuess(solver, best);
+        printf("Le mot est : %s\n", best);
+        return;
+    }
+
+    char (*words)[WORD_BYTES] = memoryAlloc(MEMORY_MAIN, top * sizeof(*words));
+    char **guesses = memoryAlloc(MEMORY_MAIN, top * sizeof(char *));
+    double *scores = memoryAlloc(MEMORY_MAIN, top * sizeof(double));
+    if (!words || !guesses || !scores)
+    {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < top; k++)
+        guesses[k] = words[k];
+
+    int count = solverTopGuesses(solver, top, guesses, scores);
+
+    static const char *const units[METRIC_KINDS] = {
+        "mots éliminés en moyenne", "bits d'information",
+        "mots éliminés au pire", "motifs possibles"
+    };
+    printf("%d mots possibles. Meilleurs essais (%s) :\n", remaining,
+           units[solverGetMetric(solver)]);
+    for (int k = 0; k < count; k++)
+        printf("  %2d. %s  %.2f\n", k + 1, guesses[k], scores[k]);
+
+    memoryFree(words);
+    memoryFree(guesses);
+    memoryFree(scores);
+}
+
+static void play_optimize(char *answers_file, char *guesses_file,
+                          char *first_guess, int threads, int shards,
+                          long table_mb, char *cache_file, char *tree_file)
+{
+    Partition *engine = partitionCreate(answers_file, guesses_file);
+    partitionBuildMatrix(engine);
+
+    Transposition *table;
+    if (shards > 1)
+    {
+        partitionMapShared(engine);
+        table = transpositionCreateShared((size_t)table_mb << 20);
+    }
+    else
+        table = transpositionCreate((size_t)table_mb << 20);
+
+    FILE *tree = NULL;
+    if (tree_file)
+    {
+        tree = fopen(tree_file, "w");
+        if (tree == NULL)
+        {
+            fprintf(stderr, "Le fichier %s n'a pas pu être ouvert: %s\n", tree_file, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    memorySetPhase(MEMORY_PLAY);
+    OptimizeResult result = optimizeRun(engine, first_guess, threads, shards,
+                                        table, cache_file, tree);
+
+    printf("Stratégie optimale sur %d mots en commençant par %s (%d threads) :\n",
+           result.games, result.guess, threads);
+    for (int k = 1; k <= OPTIMIZE_MAX_GUESSES; k++)
+        if (result.counts[k] > 0)
+            printf("  %2d essais : %d\n", k, result.counts[k]);
+    printf("Moyenne : %.4f essais par mot (%ld au total).\n",
+           (double)result.guesses / result.games, result.guesses);
+    if (DEBUG)
+        printf("DEBUG MODE: (%ld ensembles cherchés, %ld résultats repris du cache)\n",
+               result.searched, result.loaded);
+
+    memorySetPhase(MEMORY_CLEANUP);
+    if (tree)
+        fclose(tree);
+    transpositionFree(table);
+    partitionFree(engine);
+}
+
+static struct _args parse_args(int argc, char **argv)
+{
+    struct _args args = {false, false, false, false, false, false, false, false,
+                         false, false, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                         -1, 1,
+                         (int)sysconf(_SC_NPROCESSORS_ONLN), 1, 10, 64,
+                         SOLVER_AVERAGE, METRIC_EXPECTED, 0, 1};
+
+    if (argc == 1)
+    {
+        usage();
+        exit(EXIT_SUCCESS);
+    }
+
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        // Every option but --stats, --hints and --approximate is followed by a value
+        if (strcmp(argv[i], "--stats") != 0 && strcmp(argv[i], "--hints") != 0
+            && strcmp(argv[i], "--approximate") != 0 && i + 1 == argc)
+        {
+            fprintf(stderr, "Missing value for %s.\n", argv[i]);
+            usage();
+            exit(EXIT_FAILURE);
+        }
+
+        if (strcmp(argv[i], "--mode") == 0)
+        {
+            if (strcmp(argv[++i], "solver") == 0)
+            {
+                args.use_solver = true;
+            }
+            else if (strcmp(argv[i], "human") == 0)
+            {
+                args.use_solver = false;
+            }
+            else if (strcmp(argv[i], "adversarial") == 0)
+            {
+                args.use_solver = false;
+                args.adversarial = true;
+            }
+            else if (strcmp(argv[i], "tournament") == 0)
+            {
+                args.use_solver = true;
+                args.tournament = true;
+            }
+            else if (strcmp(argv[i], "whatif") == 0)
+            {
+                args.use_solver = true;
+                args.whatif = true;
+            }
+            else if (strcmp(argv[i], "assist") == 0)
+            {
+                args.use_solver = true;
+                args.assist = true;
+            }
+            else if (strcmp(argv[i], "optimize") == 0)
+            {
+                args.use_solver = true;
+                args.optimize = true;
+            }
+            else if (strcmp(argv[i], "batch") == 0)
+            {
+                args.use_solver = true;
+                args.batch = true;
+            }
+            else
+            {
+                fprintf(stderr, "Invalid mode: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--stats") == 0)
+        {
+            args.stats = true;
+        }
+
+        else if (strcmp(argv[i], "--hints") == 0)
+        {
+            args.hints = true;
+        }
+
+        else if (strcmp(argv[i], "--approximate") == 0)
+        {
+            args.approximate = true;
+        }
+
+        else if (strcmp(argv[i], "--answers-file") == 0)
+        {
+            args.answers_file = argv[++i];
+        }
+
+        else if (strcmp(argv[i], "--guesses-file") == 0)
+        {
+            args.guesses_file = argv[++i];
+        }
+
+        else if (strcmp(argv[i], "--cache") == 0)
+        {
+            args.cache_file = argv[++i];
+        }
+
+        else if (strcmp(argv[i], "--tree") == 0)
+        {
+            args.tree_file = argv[++i];
+        }
+
+        else if (strcmp(argv[i], "--trace") == 0)
+        {
+            args.trace_file = argv[++i];
+        }
+
+        else if (strcmp(argv[i], "--replay") == 0)
+        {
+            args.replay_file = argv[++i];
+        }
+
+        else if (strcmp(argv[i], "--answer") == 0)
+        {
+            args.answer = argv[++i];
+        }
+
+        else if (strcmp(argv[i], "--first-guess") == 0)
+        {
+            args.first_guess = argv[++i];
+
+            // Comma separated words of 5 letters, UTF-8 continuation
+            // bytes belonging to the letter before them
+            size_t length = 0, bytes = 0;
+            char *c;
+            for (c = args.first_guess; *c && (*c != ',' || length == 5); c++)
+            {
+                if (*c == ',')
+                    length = bytes = 0;
+                else if (++bytes >= WORD_BYTES)
+                    break;
+                else if ((*c & 0xC0) != 0x80)
+                    length++;
+            }
+
+            if (*c != '\0' || length != 5)
+            {
+                fprintf(stderr, "Invalid first guess: %s. Should contain 5 letters.\n", args.first_guess);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--time-budget-ms") == 0)
+        {
+            char *end;
+            args.time_budget_ms = strtol(argv[++i], &end, 10);
+
+            if (*end != '\0' || args.time_budget_ms < 0)
+            {
+                fprintf(stderr, "Invalid time budget: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--boards") == 0)
+        {
+            char *end;
+            args.boards = (int)strtol(argv[++i], &end, 10);
+
+            if (*end != '\0' || args.boards < 1)
+            {
+                fprintf(stderr, "Invalid number of boards: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            char *end;
+            args.threads = (int)strtol(argv[++i], &end, 10);
+
+            if (*end != '\0' || args.threads < 1)
+            {
+                fprintf(stderr, "Invalid number of threads: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--shards") == 0)
+        {
+            char *end;
+            args.shards = (int)strtol(argv[++i], &end, 10);
+
+            if (*end != '\0' || args.shards < 1)
+            {
+                fprintf(stderr, "Invalid number of shards: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--table-mb") == 0)
+        {
+            char *end;
+            args.table_mb = strtol(argv[++i], &end, 10);
+
+            if (*end != '\0' || args.table_mb < 0)
+            {
+                fprintf(stderr, "Invalid table size: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--strategy") == 0)
+        {
+            if (strcmp(argv[++i], "average") == 0)
+            {
+                args.strategy = SOLVER_AVERAGE;
+            }
+            else if (strcmp(argv[i], "minimax") == 0)
+            {
+                args.strategy = SOLVER_MINIMAX;
+            }
+            else
+            {
+                fprintf(stderr, "Invalid strategy: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--metric") == 0)
+        {
+            int metric = metricFromName(argv[++i]);
+
+            if (metric < 0)
+            {
+                fprintf(stderr, "Invalid metric: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+            args.metric = (Metric)metric;
+        }
+
+        else if (strcmp(argv[i], "--sample") == 0)
+        {
+            char *end;
+            args.sample = (int)strtol(argv[++i], &end, 10);
+
+            if (*end != '\0' || args.sample < 0 || args.sample == 1)
+            {
+                fprintf(stderr, "Invalid sample size: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--seed") == 0)
+        {
+            char *end;
+            args.seed = strtoul(argv[++i], &end, 10);
+
+            if (*end != '\0')
+            {
+                fprintf(stderr, "Invalid seed: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else if (strcmp(argv[i], "--top") == 0)
+        {
+            char *end;
+            args.top = (int)strtol(argv[++i], &end, 10);
+
+            if (*end != '\0' || args.top < 1)
+            {
+                fprintf(stderr, "Invalid number of suggestions: %s.\n", argv[i]);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        else
+        {
+            fprintf(stderr, "Invalid argument: %s.\n", argv[i]);
+            usage();
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (i != argc)
+    {
+        fprintf(stderr, "Invalid arguments.\n");
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    return args;
+}
+
+static void usage()
+{
+    fprintf(stderr, "Usage: ./wordle [--mode solver|human|adversarial|tournament|whatif|assist|optimize|batch]"
+                    "[--answers-file answers_file]"
+                    "[--guesses-file guesses_file]"
+                    "[--answer answer]"
+                    "[--first-guess first_guess]"
+                    "[--time-budget-ms ms]"
+                    "[--boards N]"
+                    "[--threads N]"
+                    "[--shards N]"
+                    "[--stats]"
+                    "[--hints]"
+                    "[--top N]"
+                    "[--table-mb N]"
+                    "[--strategy average|minimax]"
+                    "[--metric expected|entropy|largest|buckets]"
+                    "[--sample N]"
+                    "[--seed N]"
+                    "[--cache cache_file]"
+                    "[--tree tree_file]"
+                    "[--approximate]"
+                    "[--trace trace_file]"
+                    "[--replay trace_file]\n"
+                    "--mode: solver, human, adversarial (no fixed hidden word)\n"
+                    "        tournament (solver against every possible answer)\n"
+                    "        whatif (solver's reply to each pattern of --first-guess)\n"
+                    "        assist (suggestions for games played elsewhere, the word\n"
+                    "        files being reloaded when they change)\n"
+                    "        optimize (strategy with the fewest guesses in total)\n"
+                    "        or batch (next guess of each game read from the standard\n"
+                    "        input, one per line: guess pattern guess pattern...)\n"
+                    "--answers-file: file containing the list of possible answers.\n"
+                    "--guesses-file: file containing the list of accepted words.\n"
+                    "--answer: set the hidden word.\n"
+                    "--first-guess: set the first guess (only for the solver mode),\n"
+                    "               or several separated by commas for the tournament mode.\n"
+                    "--time-budget-ms: time limit of each solver move in milliseconds.\n"
+                    "--boards: number of boards played at once (not with --answer or adversarial).\n"
+                    "--threads: number of threads of the tournament, whatif and batch modes.\n"
+                    "--shards: number of processes the tournament and optimize modes are\n"
+                    "          spread over, each with --threads threads.\n"
+                    "--stats: print the allocations of each module and phase at exit, and the\n"
+                    "         pattern kernel chosen (forced by the WORDLE_KERNEL environment\n"
+                    "         variable: scalar, sse4.2, avx2 or avx512).\n"
+                    "--hints: type ? to get the solver's suggestion (human and adversarial modes).\n"
+                    "--top: number of guesses suggested by the assist mode.\n"
+                    "--table-mb: size of the transposition table of the tournament and optimize modes,\n"
+                    "            and of the minimax solver mode (0 for none).\n"
+                    "--strategy: best score of --metric (average, the default), or fewest\n"
+                    "            guesses in the worst case (minimax).\n"
+                    "--metric: score of the solver's guesses: fewest answers left on average\n"
+                    "          (expected, the default), most information (entropy), smallest\n"
+                    "          largest bucket (largest) or most patterns (buckets).\n"
+                    "--sample: estimate the expected and entropy scores on N random answers,\n"
+                    "          counting exactly only the guesses that may be the best\n"
+                    "          (solver, tournament and batch modes, 0 for exact scores).\n"
+                    "--seed: seed of the samples (1 by default).\n"
+                    "--cache: file keeping the results of the optimize mode, to resume it.\n"
+                    "--tree: decision tree written by the optimize mode, and followed\n"
+                    "        by the solver mode.\n"
+                    "--approximate: only score the guesses ranked best by letter frequencies\n"
+                    "               (solver, tournament and batch modes).\n"
+                    "--trace: append each game to a binary trace (solver, human and adversarial modes).\n"
+                    "--replay: replay the games of a trace through the solver, and compare its\n"
+                    "          guesses and their latency with the recorded ones.\n");
+}
+
+int main(int argc, char **argv)
+{
+    struct _args args = parse_args(argc, argv);
+
+    if (args.answers_file == NULL)
+    {
+        fprintf(stderr, "Missing answers file.\n");
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (args.guesses_file == NULL)
+    {
+        fprintf(stderr, "Missing guesses file.\n");
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (args.first_guess && !args.tournament
+        && strchr(args.first_guess, ','))
+    {
+        fprintf(stderr, "Several first guesses can only be given to the tournament mode.\n");
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (args.tree_file && (!args.use_solver || args.tournament || args.whatif
+                           || args.assist || args.batch || args.boards > 1))
+    {
+        fprintf(stderr, "--tree can only be used by the solver and optimize modes.\n");
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (args.trace_file && (args.tournament || args.whatif || args.assist
+                            || args.optimize || args.batch || args.replay_file
+                            || args.boards > 1))
+    {
+        fprintf(stderr, "--trace can only be used by the solver, human and adversarial modes.\n");
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (args.shards > 1 && !args.tournament && !args.optimize)
+    {
+        fprintf(stderr, "--shards can only be used by the tournament and optimize modes.\n");
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    srand(time(NULL));
+
+    if (args.replay_file)
+    {
+        play_replay(args.answers_file, args.guesses_file, args.replay_file,
+                    args.table_mb);
+    }
+    else if (args.optimize)
+    {
+        if (args.table_mb == 0)
+        {
+            fprintf(stderr, "The optimize mode needs a transposition table.\n");
+            usage();
+            exit(EXIT_FAILURE);
+        }
+
+        play_optimize(args.answers_file, args.guesses_file, args.first_guess,
+                      args.threads, args.shards, args.table_mb, args.cache_file,
+                      args.tree_file);
+    }
+    else if (args.tournament)
+    {
+        play_tournament(args.answers_file, args.guesses_file,
+                        args.first_guess, args.threads, args.shards,
+                        args.table_mb, args.strategy, args.metric,
+                        args.sample, args.seed, args.approximate);
+    }
+    else if (args.batch)
+    {
+        play_batch(args.answers_file, args.guesses_file, args.threads,
+                   args.metric, args.sample, args.seed, args.approximate);
+    }
+    else if (args.assist)
+    {
+        play_assist(args.answers_file, args.guesses_file, args.top,
+                    args.metric);
+    }
+    else if (args.whatif)
+    {
+        if (args.first_guess == NULL)
+        {
+            fprintf(stderr, "The whatif mode needs --first-guess.\n");
+            usage();
+            exit(EXIT_FAILURE);
+        }
+
+        play_whatif(args.answers_file, args.guesses_file,
+                    args.first_guess, args.threads, args.strategy,
+                    args.metric);
+    }
+    else if (args.boards > 1)
+    {
+        if (args.adversarial || args.answer)
+        {
+            fprintf(stderr, "--boards cannot be used with --answer or the adversarial mode.\n");
+            usage();
+            exit(EXIT_FAILURE);
+        }
+
+        play_boards(args.use_solver, args.boards, args.answers_file,
+                    args.guesses_file, args.first_guess, args.time_budget_ms,
+                    args.metric, args.approximate);
+    }
+    else
+    {
+        play(args.use_solver, args.adversarial, args.answers_file,
+             args.guesses_file, args.answer, args.first_guess,
+             args.time_budget_ms, args.hints, args.strategy, args.metric,
+             args.sample, args.seed, args.approximate, args.table_mb,
+             args.tree_file, args.trace_file);
+    }
+
+    if (args.stats)
+    {
+        memoryReport(stderr);
+        kernelReport(stderr);
+    }
 
     return 0;
 }
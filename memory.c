@@ -0,0 +1,280 @@
+#define _DEFAULT_SOURCE
+
+#include "memory.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+
+/**
+ * @brief Prefix of every block, recording what to count when it is freed.
+ * The union keeps the memory after it aligned for any type.
+ */
+typedef union
+{
+    struct
+    {
+        size_t size;
+        int module;
+    } block;
+    long double align;
+} Header;
+
+typedef struct
+{
+    long allocations; // Calls to alloc, calloc and realloc
+    long bytes;       // Bytes requested by these calls
+    long frees;
+    long liveObjects; // Blocks allocated and not freed yet
+    long liveBytes;
+    long peakBytes;   // Maximum of liveBytes (of every module for a phase)
+} Counters;
+
+
+static void *libcAlloc(void *context, size_t size);
+static void *libcRealloc(void *context, void *p, size_t size);
+static void libcFree(void *context, void *p);
+static void countAllocation(int module, long objects, long bytes);
+static void countFree(int module, long bytes);
+static void raisePeak(long *peak, long value);
+static void printCounters(FILE *out, const char *name, const Counters *c);
+
+
+static MemoryAllocator allocator = {libcAlloc, libcRealloc, libcFree, NULL};
+static int phase = MEMORY_LOAD;
+
+// Updated atomically, as modules allocate from several threads
+static Counters modules[MEMORY_MODULES];
+static Counters phases[MEMORY_PHASES];
+static long liveBytes;
+
+static const char *moduleNames[MEMORY_MODULES] = {
+    "main", "LinkedList", "dict", "wordle", "partition", "solver",
+    "scheduler", "tournament", "hints", "transposition", "minimax",
+    "optimize", "tree", "alphabet", "trace", "wordlists", "shard",
+    "libwordle"
+};
+static const char *phaseNames[MEMORY_PHASES] = {
+    "chargement", "jeu", "libération"
+};
+
+
+void *memoryAlloc(MemoryModule module, size_t size)
+{
+    if (size > SIZE_MAX - sizeof(Header))
+        return NULL;
+
+    Header *header = allocator.alloc(allocator.context, sizeof(Header) + size);
+    if (header == NULL)
+        return NULL;
+
+    header->block.size = size;
+    header->block.module = module;
+    countAllocation(module, 1, (long)size);
+
+    return header + 1;
+}
+
+
+void *memoryCalloc(MemoryModule module, size_t count, size_t size)
+{
+    if (size != 0 && count > SIZE_MAX / size)
+        return NULL;
+
+    void *p = memoryAlloc(module, count * size);
+    if (p)
+        memset(p, 0, count * size);
+
+    return p;
+}
+
+
+void *memoryRealloc(MemoryModule module, void *p, size_t size)
+{
+    if (p == NULL)
+        return memoryAlloc(module, size);
+
+    if (size > SIZE_MAX - sizeof(Header))
+        return NULL;
+
+    Header *header = (Header *)p - 1;
+    size_t old = header->block.size;
+
+    header = allocator.realloc(allocator.context, header, sizeof(Header) + size);
+    if (header == NULL)
+        return NULL;
+
+    header->block.size = size;
+    countAllocation(header->block.module, 0, (long)size - (long)old);
+
+    return header + 1;
+}
+
+
+void memoryFree(void *p)
+{
+    if (p == NULL)
+        return;
+
+    Header *header = (Header *)p - 1;
+    countFree(header->block.module, (long)header->block.size);
+    allocator.free(allocator.context, header);
+}
+
+
+void *memoryMapShared(MemoryModule module, size_t size)
+{
+    if (size > SIZE_MAX - sizeof(Header))
+        return NULL;
+
+    Header *header = mmap(NULL, sizeof(Header) + size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (header == MAP_FAILED)
+        return NULL;
+
+    header->block.size = size;
+    header->block.module = module;
+    countAllocation(module, 1, (long)size);
+
+    return header + 1;
+}
+
+
+void memorySealShared(void *p)
+{
+    Header *header = (Header *)p - 1;
+    mprotect(header, sizeof(Header) + header->block.size, PROT_READ);
+}
+
+
+void memoryUnmapShared(void *p)
+{
+    if (p == NULL)
+        return;
+
+    Header *header = (Header *)p - 1;
+    size_t size = header->block.size;
+
+    countFree(header->block.module, (long)size);
+    munmap(header, sizeof(Header) + size);
+}
+
+
+void memorySetAllocator(const MemoryAllocator *replacement)
+{
+    if (replacement)
+        allocator = *replacement;
+    else {
+        allocator.alloc = libcAlloc;
+        allocator.realloc = libcRealloc;
+        allocator.free = libcFree;
+        allocator.context = NULL;
+    }
+}
+
+
+void memorySetPhase(MemoryPhase next)
+{
+    __atomic_store_n(&phase, next, __ATOMIC_SEQ_CST);
+    raisePeak(&phases[next].peakBytes, __atomic_load_n(&liveBytes, __ATOMIC_SEQ_CST));
+}
+
+
+void memoryReport(FILE *out)
+{
+    fprintf(out, "Mémoire par module :\n");
+    fprintf(out, "  %-12s %12s %14s %12s %10s %14s %14s\n", "module",
+            "allocations", "octets", "libérations", "vivants",
+            "octets vivants", "pic (octets)");
+    for (int m = 0; m < MEMORY_MODULES; m++)
+        printCounters(out, moduleNames[m], &modules[m]);
+
+    fprintf(out, "Mémoire par phase (pic de tous les modules) :\n");
+    for (int p = 0; p < MEMORY_PHASES; p++)
+        printCounters(out, phaseNames[p], &phases[p]);
+}
+
+
+static void *libcAlloc(void *context, size_t size)
+{
+    (void)context;
+    return malloc(size);
+}
+
+
+static void *libcRealloc(void *context, void *p, size_t size)
+{
+    (void)context;
+    return realloc(p, size);
+}
+
+
+static void libcFree(void *context, void *p)
+{
+    (void)context;
+    free(p);
+}
+
+
+/**
+ * @brief Counts `objects` new blocks and `bytes` more live bytes (negative
+ * when a block shrinks).
+ */
+static void countAllocation(int module, long objects, long bytes)
+{
+    Counters *m = &modules[module];
+    Counters *p = &phases[__atomic_load_n(&phase, __ATOMIC_RELAXED)];
+
+    __atomic_add_fetch(&m->allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&p->allocations, 1, __ATOMIC_RELAXED);
+    if (bytes > 0) {
+        __atomic_add_fetch(&m->bytes, bytes, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&p->bytes, bytes, __ATOMIC_RELAXED);
+    }
+    __atomic_add_fetch(&m->liveObjects, objects, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&p->liveObjects, objects, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&p->liveBytes, bytes, __ATOMIC_RELAXED);
+
+    raisePeak(&m->peakBytes, __atomic_add_fetch(&m->liveBytes, bytes, __ATOMIC_RELAXED));
+    raisePeak(&p->peakBytes, __atomic_add_fetch(&liveBytes, bytes, __ATOMIC_RELAXED));
+}
+
+
+static void countFree(int module, long bytes)
+{
+    Counters *m = &modules[module];
+    Counters *p = &phases[__atomic_load_n(&phase, __ATOMIC_RELAXED)];
+
+    __atomic_add_fetch(&m->frees, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&p->frees, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&m->liveObjects, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&p->liveObjects, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&m->liveBytes, bytes, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&p->liveBytes, bytes, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&liveBytes, bytes, __ATOMIC_RELAXED);
+}
+
+
+static void raisePeak(long *peak, long value)
+{
+    long current = __atomic_load_n(peak, __ATOMIC_RELAXED);
+
+    while (value > current
+           && !__atomic_compare_exchange_n(peak, &current, value, 1,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+
+/**
+ * @brief Prints a line of the report. The live counters of a phase are the
+ * net change over the phase.
+ */
+static void printCounters(FILE *out, const char *name, const Counters *c)
+{
+    fprintf(out, "  %-12s %12ld %14ld %12ld %10ld %14ld %14ld\n", name,
+            c->allocations, c->bytes, c->frees, c->liveObjects, c->liveBytes,
+            c->peakBytes);
+}
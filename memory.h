@@ -0,0 +1,153 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief Modules whose allocations are counted separately.
+ */
+typedef enum
+{
+    MEMORY_MAIN,
+    MEMORY_LIST,
+    MEMORY_DICT,
+    MEMORY_WORDLE,
+    MEMORY_PARTITION,
+    MEMORY_SOLVER,
+    MEMORY_SCHEDULER,
+    MEMORY_TOURNAMENT,
+    MEMORY_HINTS,
+    MEMORY_TRANSPOSITION,
+    MEMORY_MINIMAX,
+    MEMORY_OPTIMIZE,
+    MEMORY_TREE,
+    MEMORY_ALPHABET,
+    MEMORY_TRACE,
+    MEMORY_WORDLISTS,
+    MEMORY_SHARD,
+    MEMORY_LIBRARY,
+    MEMORY_MODULES // Number of modules
+} MemoryModule;
+
+/**
+ * @brief Phases of the program whose allocations are counted separately.
+ */
+typedef enum
+{
+    MEMORY_LOAD,    // Reading the word lists and building the tables
+    MEMORY_PLAY,    // Games, solver searches and tournaments
+    MEMORY_CLEANUP, // Freeing everything before exiting
+    MEMORY_PHASES   // Number of phases
+} MemoryPhase;
+
+/**
+ * @brief Allocator behind the hook layer. Every function gets `context`
+ * as its first argument, and follows the contract of its C library
+ * counterpart.
+ */
+typedef struct MemoryAllocator_t
+{
+    void *(*alloc)(void *context, size_t size);
+    void *(*realloc)(void *context, void *p, size_t size);
+    void (*free)(void *context, void *p);
+    void *context;
+} MemoryAllocator;
+
+/**
+ * @brief Allocates memory on behalf of a module, like malloc.
+ *
+ * @param module Module the memory is counted for.
+ * @param size Number of bytes.
+ *
+ * @return The memory, or NULL if it could not be allocated.
+ */
+void *memoryAlloc(MemoryModule module, size_t size);
+
+/**
+ * @brief Allocates zeroed memory on behalf of a module, like calloc.
+ *
+ * @param module Module the memory is counted for.
+ * @param count Number of elements.
+ * @param size Size of an element.
+ *
+ * @return The memory, or NULL if it could not be allocated.
+ */
+void *memoryCalloc(MemoryModule module, size_t count, size_t size);
+
+/**
+ * @brief Resizes memory allocated by the hook layer, like realloc. It stays
+ * counted for the module which allocated it (`module` is used when `p` is
+ * NULL).
+ *
+ * @param module Module the memory is counted for.
+ * @param p Memory to resize, or NULL.
+ * @param size New number of bytes.
+ *
+ * @return The resized memory, or NULL if it could not be resized (`p` is
+ * then left untouched).
+ */
+void *memoryRealloc(MemoryModule module, void *p, size_t size);
+
+/**
+ * @brief Frees memory allocated by the hook layer, whichever module
+ * allocated it.
+ *
+ * @param p Memory to free, or NULL.
+ */
+void memoryFree(void *p);
+
+/**
+ * @brief Maps memory shared with the processes forked afterwards, on
+ * behalf of a module: they see each other's writes, and the pages are
+ * never copied, however many processes use them. The memory is zeroed,
+ * and counted like an allocation.
+ *
+ * @param module Module the memory is counted for.
+ * @param size Number of bytes.
+ *
+ * @return The memory, or NULL if it could not be mapped.
+ */
+void *memoryMapShared(MemoryModule module, size_t size);
+
+/**
+ * @brief Makes memory mapped by memoryMapShared read-only, so that a
+ * stray write faults instead of corrupting what every process reads.
+ *
+ * @param p The memory.
+ */
+void memorySealShared(void *p);
+
+/**
+ * @brief Unmaps memory mapped by memoryMapShared. Each process which
+ * inherited it unmaps its own view.
+ *
+ * @param p Memory to unmap, or NULL.
+ */
+void memoryUnmapShared(void *p);
+
+/**
+ * @brief Replaces the allocator behind the hook layer, for example by an
+ * arena or by an allocator failing on purpose. Memory must be freed by the
+ * allocator which allocated it.
+ *
+ * @param allocator The allocator (copied), or NULL for the C library.
+ */
+void memorySetAllocator(const MemoryAllocator *allocator);
+
+/**
+ * @brief Sets the phase the next allocations and frees are counted for.
+ *
+ * @param phase The phase.
+ */
+void memorySetPhase(MemoryPhase phase);
+
+/**
+ * @brief Prints the number of allocations, bytes, live objects and peak
+ * usage of each module and phase.
+ *
+ * @param out Stream to print to.
+ */
+void memoryReport(FILE *out);
+
+#endif
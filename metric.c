@@ -0,0 +1,221 @@
+#include "metric.h"
+#include "wordle.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+
+static const char *const metricNames[METRIC_KINDS] = {
+    "expected", "entropy", "largest", "buckets"
+};
+
+// h log2(h) in fixed point, for the buckets smaller than the table
+static uint64_t nLogN[METRIC_TABLE_SIZE];
+static pthread_once_t tabulated = PTHREAD_ONCE_INIT;
+
+
+static void tabulate(void);
+static uint64_t fixedNLogN(int h);
+static double scoreExpected(const int *histogram, int n);
+static double scoreEntropy(const int *histogram, int n);
+static double scoreLargest(const int *histogram, int n);
+static double scoreBuckets(const int *histogram, int n);
+static void estimateExpected(const int *histogram, int m, int n, double z,
+                             double *estimate, double *low, double *high);
+static void estimateEntropy(const int *histogram, int m, int n, double z,
+                            double *estimate, double *low, double *high);
+static double finiteCorrection(int m, int n);
+
+
+MetricScore metricFunction(Metric metric)
+{
+    switch (metric) {
+    case METRIC_ENTROPY:
+        pthread_once(&tabulated, tabulate);
+        return scoreEntropy;
+    case METRIC_LARGEST:
+        return scoreLargest;
+    case METRIC_BUCKETS:
+        return scoreBuckets;
+    default:
+        return scoreExpected;
+    }
+}
+
+
+MetricInterval metricIntervalFunction(Metric metric)
+{
+    switch (metric) {
+    case METRIC_EXPECTED:
+        return estimateExpected;
+    case METRIC_ENTROPY:
+        return estimateEntropy;
+    default:
+        return NULL;
+    }
+}
+
+
+const char *metricName(Metric metric)
+{
+    return metricNames[metric];
+}
+
+
+int metricFromName(const char *name)
+{
+    for (int m = 0; m < METRIC_KINDS; m++)
+        if (strcmp(name, metricNames[m]) == 0)
+            return m;
+
+    return -1;
+}
+
+
+static void tabulate(void)
+{
+    for (int h = 0; h < METRIC_TABLE_SIZE; h++)
+        nLogN[h] = fixedNLogN(h);
+}
+
+
+static uint64_t fixedNLogN(int h)
+{
+    if (h <= 1)
+        return 0;
+
+    return (uint64_t)llround(h * log2(h) * (1 << METRIC_ENTROPY_BITS));
+}
+
+
+/**
+ * @brief Every answer of a bucket eliminates the answers of all other
+ * buckets: sum of h (n - h) over n, that is (n^2 - sum of h^2) / n.
+ */
+static double scoreExpected(const int *histogram, int n)
+{
+    int64_t squares = 0;
+
+    for (int p = 0; p < PATTERN_COUNT; p++)
+        squares += (int64_t)histogram[p] * histogram[p];
+
+    return (double)((int64_t)n * n - squares) / n;
+}
+
+
+/**
+ * @brief Sum of h/n log2(n/h), that is (n log2 n - sum of h log2 h) / n.
+ */
+static double scoreEntropy(const int *histogram, int n)
+{
+    uint64_t sum = 0;
+
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        int h = histogram[p];
+        sum += h < METRIC_TABLE_SIZE ? nLogN[h] : fixedNLogN(h);
+    }
+
+    uint64_t total = n < METRIC_TABLE_SIZE ? nLogN[n] : fixedNLogN(n);
+
+    // Rounding may leave a single bucket slightly above n log n
+    if (sum >= total)
+        return 0.;
+
+    return (double)(total - sum) / ((double)n * (1 << METRIC_ENTROPY_BITS));
+}
+
+
+static double scoreLargest(const int *histogram, int n)
+{
+    int largest = 0;
+
+    for (int p = 0; p < PATTERN_COUNT; p++)
+        if (histogram[p] > largest)
+            largest = histogram[p];
+
+    return n - largest;
+}
+
+
+static double scoreBuckets(const int *histogram, int n)
+{
+    int buckets = 0;
+
+    (void)n;
+    for (int p = 0; p < PATTERN_COUNT; p++)
+        buckets += histogram[p] > 0;
+
+    return buckets;
+}
+
+
+/**
+ * @brief The score is (n - 1)(1 - c), c being the probability that two
+ * distinct answers share a pattern, estimated by the pairs of the sample.
+ * Its variance is about 4 (sum of q^3 - (sum of q^2)^2) / m, q being the
+ * share of each pattern.
+ */
+static void estimateExpected(const int *histogram, int m, int n, double z,
+                             double *estimate, double *low, double *high)
+{
+    int64_t pairs = 0;
+    double squares = 0., cubes = 0.;
+
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        int h = histogram[p];
+        double q = (double)h / m;
+        pairs += (int64_t)h * (h - 1);
+        squares += q * q;
+        cubes += q * q * q;
+    }
+
+    double c = (double)pairs / ((double)m * (m - 1));
+    double variance = 4. * (cubes - squares * squares) / m;
+    double half = z * (n - 1) * sqrt((variance > 0. ? variance : 0.) * finiteCorrection(m, n));
+
+    *estimate = (n - 1) * (1. - c);
+    *low = *estimate - half;
+    *high = *estimate + half;
+}
+
+
+/**
+ * @brief The entropy is the mean of -log2 q over the answers, estimated by
+ * its value on the sample plus (K - 1) / (2 m ln 2) for its bias, K being
+ * the number of patterns met.
+ */
+static void estimateEntropy(const int *histogram, int m, int n, double z,
+                            double *estimate, double *low, double *high)
+{
+    double entropy = 0., moment = 0.;
+    int buckets = 0;
+
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        if (histogram[p] == 0)
+            continue;
+
+        double q = (double)histogram[p] / m;
+        entropy -= q * log2(q);
+        moment += q * log2(q) * log2(q);
+        buckets++;
+    }
+
+    double variance = (moment - entropy * entropy) / m;
+    double half = z * sqrt((variance > 0. ? variance : 0.) * finiteCorrection(m, n));
+
+    *estimate = entropy + (buckets - 1) / (2. * m * log(2.));
+    *low = *estimate - half;
+    *high = *estimate + half;
+}
+
+
+/**
+ * @brief Shrinks the variance of a sample taking a large share of the
+ * answers, down to 0 for all of them.
+ */
+static double finiteCorrection(int m, int n)
+{
+    return n > 1 ? (double)(n - m) / (n - 1) : 0.;
+}
@@ -0,0 +1,91 @@
+#ifndef METRIC_H
+#define METRIC_H
+
+#define METRIC_ENTROPY_BITS (24) // Fractional bits of the n log n table
+#define METRIC_TABLE_SIZE (4096) // Buckets whose n log n is tabulated
+
+/**
+ * @brief Criteria scoring a guess from the histogram of the patterns it
+ * splits the possible answers into. Every score is non-negative, and the
+ * higher the better.
+ */
+typedef enum
+{
+    METRIC_EXPECTED, // Answers eliminated on average: n minus the expected
+                     // size of the bucket of the answer (the default)
+    METRIC_ENTROPY,  // Shannon entropy of the buckets, in bits
+    METRIC_LARGEST,  // Answers eliminated in the worst case: n minus the
+                     // largest bucket
+    METRIC_BUCKETS,  // Number of non-empty buckets
+    METRIC_KINDS     // Number of metrics
+} Metric;
+
+/**
+ * @brief Scores a histogram of PATTERN_COUNT buckets.
+ *
+ * @param histogram Number of answers giving each pattern.
+ * @param n Number of answers, the sum of the histogram.
+ *
+ * @return the score.
+ */
+typedef double (*MetricScore)(const int *histogram, int n);
+
+/**
+ * @brief Estimates the score of a guess over n answers from the histogram
+ * of a random sample of m of them, drawn without replacement.
+ *
+ * @param histogram Number of sampled answers giving each pattern.
+ * @param m Size of the sample, the sum of the histogram.
+ * @param n Number of answers sampled from.
+ * @param z Half-width of the interval, in standard deviations.
+ * @param estimate Set to the estimated score.
+ * @param low Set to the lower end of the confidence interval.
+ * @param high Set to the upper end of the confidence interval.
+ */
+typedef void (*MetricInterval)(const int *histogram, int m, int n, double z,
+                               double *estimate, double *low, double *high);
+
+/**
+ * @brief Get the function computing a metric. Sums are accumulated on
+ * integers, the entropy from a table of h log2(h) in fixed point, so that
+ * each metric is a single cheap pass over the histogram.
+ *
+ * @param metric The metric.
+ *
+ * @return the function.
+ */
+MetricScore metricFunction(Metric metric);
+
+/**
+ * @brief Get the function estimating a metric from a sample. Both
+ * estimates follow the normal approximation, with the finite population
+ * correction: the expected size from the pairs of sampled answers sharing
+ * a pattern, the entropy from its plug-in value with the Miller-Madow bias
+ * correction.
+ *
+ * @param metric The metric.
+ *
+ * @return the function, or NULL if the metric cannot be estimated (the
+ * largest bucket and the number of buckets depend on rare patterns).
+ */
+MetricInterval metricIntervalFunction(Metric metric);
+
+/**
+ * @brief Get the name of a metric, as given on the command line.
+ *
+ * @param metric The metric.
+ *
+ * @return the name.
+ */
+const char *metricName(Metric metric);
+
+/**
+ * @brief Finds a metric by its name.
+ *
+ * @param name expected, entropy, largest or buckets.
+ *
+ * @return the metric, or -1 if there is none of this name.
+ */
+int metricFromName(const char *name);
+
+#endif
@@ -0,0 +1,302 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "minimax.h"
+#include "wordle.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+
+/**
+ * @brief State of a search, shared by its recursive calls.
+ */
+typedef struct
+{
+    const Partition *p;
+    Transposition *table;
+    struct timespec start;
+    long budget_ms;
+    int expired; // Set once the budget has run out
+} Search;
+
+/**
+ * @brief Guess tried on a state, with the sizes of its pattern buckets.
+ */
+typedef struct
+{
+    int guess;
+    int worst;   // Size of the largest bucket, the solved one excepted
+    int buckets; // Number of non-empty buckets
+} Candidate;
+
+
+static int solvable(Search *s, const int *answers, int n, int depth,
+                    int *guess);
+static int proveGuess(Search *s, const int *answers, int n, int depth,
+                      int guess);
+static int rankCandidates(Search *s, const int *answers, int n, int limit,
+                          int worstAllowed, Candidate *ranked);
+static int isBetter(const Candidate *a, const Candidate *b);
+static long capacity(int depth);
+static uint64_t stateKey(Search *s, const int *answers, int n, int depth);
+static int outOfTime(Search *s);
+static void expectNotNull(void *p);
+
+
+int minimaxBestGuess(const Partition *p, const int *answers, int n,
+                     long budget_ms, Transposition *table, int *guesses)
+{
+    Search s;
+    int guess;
+
+    s.p = p;
+    s.table = table;
+    s.budget_ms = budget_ms;
+    s.expired = 0;
+    clock_gettime(CLOCK_MONOTONIC, &s.start);
+
+    *guesses = 0;
+
+    for (int depth = 1; depth <= MINIMAX_MAX_GUESSES && !s.expired; depth++) {
+        if (n <= capacity(depth) && solvable(&s, answers, n, depth, &guess)) {
+            *guesses = depth;
+            return guess;
+        }
+    }
+
+    // No bound proven: the guess leaving the fewest answers in the worst case
+    Candidate best;
+    s.expired = 0;
+    s.budget_ms = -1;
+    rankCandidates(&s, answers, n, 1, n, &best);
+
+    return best.guess;
+}
+
+
+/**
+ * @brief Whether every answer of a set can be solved within `depth`
+ * guesses, trying the best candidates of the beam.
+ *
+ * @return 1 with the first guess of a proof in `guess`, 0 if none was
+ * found (or the budget ran out).
+ */
+static int solvable(Search *s, const int *answers, int n, int depth,
+                    int *guess)
+{
+    if (n == 1) {
+        *guess = partitionFindGuess(s->p, partitionAnswer(s->p, answers[0]));
+        return depth >= 1;
+    }
+    if (depth <= 1 || n > capacity(depth))
+        return 0;
+
+    uint64_t key = 0;
+    double bound;
+    if (s->table) {
+        key = stateKey(s, answers, n, depth);
+        if (transpositionLookup(s->table, key, n, guess, &bound))
+            return *guess >= 0;
+    }
+
+    if (outOfTime(s))
+        return 0;
+
+    // Buckets larger than what depth - 1 guesses can solve rule a guess out
+    Candidate ranked[MINIMAX_BEAM];
+    int count = rankCandidates(s, answers, n, MINIMAX_BEAM,
+                               (int)capacity(depth - 1), ranked);
+    int found = 0;
+
+    for (int c = 0; c < count && !found && !s->expired; c++) {
+        // With at most one answer per bucket, the next guess solves it
+        if (ranked[c].worst <= 1 || proveGuess(s, answers, n, depth, ranked[c].guess)) {
+            *guess = ranked[c].guess;
+            found = 1;
+        }
+    }
+
+    if (s->table && (found || !s->expired))
+        transpositionStore(s->table, key, n, found ? *guess : -1, depth);
+
+    return found;
+}
+
+
+/**
+ * @brief Whether every pattern bucket of a guess can be solved within
+ * `depth` - 1 guesses. Buckets are tried largest first, and the first
+ * failure cuts the others off.
+ */
+static int proveGuess(Search *s, const int *answers, int n, int depth,
+                      int guess)
+{
+    int start[PATTERN_COUNT + 1] = {0};
+    int order[PATTERN_COUNT];
+    int nbBuckets = 0;
+    int i, k, unused;
+
+    int *codes = memoryAlloc(MEMORY_MINIMAX, n * sizeof(int));
+    int *buckets = memoryAlloc(MEMORY_MINIMAX, n * sizeof(int));
+    expectNotNull(codes);
+    expectNotNull(buckets);
+
+    // Counting sort of the answers by pattern
+    for (i = 0; i < n; i++) {
+        codes[i] = partitionPattern(s->p, guess, answers[i]);
+        start[codes[i] + 1]++;
+    }
+    for (k = 0; k < PATTERN_COUNT; k++)
+        start[k + 1] += start[k];
+
+    int next[PATTERN_COUNT];
+    memcpy(next, start, sizeof(next));
+    for (i = 0; i < n; i++)
+        buckets[next[codes[i]]++] = answers[i];
+
+    // Buckets of two answers or more, by decreasing size
+    for (k = 0; k < PATTERN_SOLVED; k++) {
+        int size = start[k + 1] - start[k];
+        if (size < 2)
+            continue;
+        for (i = nbBuckets++; i > 0 && start[order[i - 1] + 1] - start[order[i - 1]] < size; i--)
+            order[i] = order[i - 1];
+        order[i] = k;
+    }
+
+    int proven = 1;
+    for (i = 0; i < nbBuckets && proven; i++) {
+        k = order[i];
+        proven = solvable(s, buckets + start[k], start[k + 1] - start[k],
+                          depth - 1, &unused);
+    }
+
+    memoryFree(codes);
+    memoryFree(buckets);
+
+    return proven;
+}
+
+
+/**
+ * @brief Selects the `limit` best guesses on a set: smallest largest
+ * bucket first, then most buckets, then lowest index. Guesses with a
+ * bucket larger than `worstAllowed` are left out.
+ *
+ * @return the number of guesses stored in `ranked`, best first.
+ */
+static int rankCandidates(Search *s, const int *answers, int n, int limit,
+                          int worstAllowed, Candidate *ranked)
+{
+    int histogram[PATTERN_COUNT] = {0};
+    int count = 0;
+    int Ng = partitionNbGuesses(s->p);
+    int i;
+
+    unsigned char *codes = memoryAlloc(MEMORY_MINIMAX, n);
+    expectNotNull(codes);
+
+    for (int g = 0; g < Ng; g++) {
+        Candidate c = {g, 0, 0};
+
+        for (i = 0; i < n; i++) {
+            int code = partitionPattern(s->p, g, answers[i]);
+            codes[i] = (unsigned char)code;
+            if (histogram[code]++ == 0)
+                c.buckets++;
+            if (code != PATTERN_SOLVED && histogram[code] > c.worst) {
+                c.worst = histogram[code];
+                if (c.worst > worstAllowed) {
+                    i++;
+                    break;
+                }
+            }
+        }
+
+        // Only the counters touched are reset
+        while (i-- > 0)
+            histogram[codes[i]] = 0;
+
+        if (c.worst > worstAllowed || (count == limit && !isBetter(&c, &ranked[count - 1])))
+            continue;
+
+        // Insertion in the sorted selection, dropping its last one if full
+        if (count < limit)
+            count++;
+        for (i = count - 1; i > 0 && isBetter(&c, &ranked[i - 1]); i--)
+            ranked[i] = ranked[i - 1];
+        ranked[i] = c;
+    }
+
+    memoryFree(codes);
+
+    return count;
+}
+
+
+static int isBetter(const Candidate *a, const Candidate *b)
+{
+    if (a->worst != b->worst)
+        return a->worst < b->worst;
+    if (a->buckets != b->buckets)
+        return a->buckets > b->buckets;
+
+    return a->guess < b->guess;
+}
+
+
+/**
+ * @brief Upper bound of the number of answers `depth` guesses can solve:
+ * one by the guess itself, and for each other pattern what depth - 1
+ * guesses can solve.
+ */
+static long capacity(int depth)
+{
+    long n = 0;
+
+    for (int d = 0; d < depth && n < 1000000000L; d++)
+        n = 1 + (PATTERN_COUNT - 1) * n;
+
+    return n;
+}
+
+
+/**
+ * @brief Zobrist hash of a set, made different for every depth.
+ */
+static uint64_t stateKey(Search *s, const int *answers, int n, int depth)
+{
+    uint64_t key = 0x6d696e696d6178ull * (uint64_t)(depth + 1);
+
+    for (int i = 0; i < n; i++)
+        key ^= partitionAnswerKey(s->p, 0, answers[i]);
+
+    return key;
+}
+
+
+static int outOfTime(Search *s)
+{
+    struct timespec now;
+
+    if (s->budget_ms < 0 || s->expired)
+        return s->expired;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if ((now.tv_sec - s->start.tv_sec) * 1000L
+        + (now.tv_nsec - s->start.tv_nsec) / 1000000L >= s->budget_ms)
+        s->expired = 1;
+
+    return s->expired;
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
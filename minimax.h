@@ -0,0 +1,39 @@
+#ifndef MINIMAX_H
+#define MINIMAX_H
+
+#include "partition.h"
+#include "transposition.h"
+
+#define MINIMAX_MAX_GUESSES (6) // Deepest bound tried by iterative deepening
+#define MINIMAX_BEAM (32)       // Guesses tried per state, fewest worst-case answers first
+
+/**
+ * @brief Finds a guess minimizing the worst-case number of guesses needed
+ * to solve a set of possible answers.
+ *
+ * Bounds of 1, 2, ... MINIMAX_MAX_GUESSES guesses are tried in turn
+ * (iterative deepening), so that a shallow guarantee is found quickly. For
+ * a bound, a guess is proven by proving every one of its pattern buckets
+ * within one guess less, largest bucket first; the first bucket failing
+ * cuts the guess off and its other buckets are not explored. Only the
+ * MINIMAX_BEAM guesses with the smallest largest bucket are tried per
+ * state, so a proven bound is a guarantee but a failed one is not a proof
+ * of impossibility.
+ *
+ * @param p The engine.
+ * @param answers Indices of the possible answers.
+ * @param n Number of possible answers (at least 1).
+ * @param budget_ms Time budget in milliseconds (negative for no limit).
+ * @param table Table remembering the bounds proven or failed by state and
+ * depth, shared between searches (NULL for none).
+ * @param guesses Filled with the number of guesses, this one included,
+ * within which every answer is guaranteed to be solved, or 0 if no bound
+ * could be proven.
+ *
+ * @return the index of the guess. Without a proven bound, the guess whose
+ * largest bucket is the smallest.
+ */
+int minimaxBestGuess(const Partition *p, const int *answers, int n,
+                     long budget_ms, Transposition *table, int *guesses);
+
+#endif
@@ -0,0 +1,934 @@
+#include "optimize.h"
+#include "scheduler.h"
+#include "tree.h"
+#include "memory.h"
+#include "shard.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+
+#define OPTIMIZE_INFINITY (LONG_MAX / 4) // Bound of a search which cannot be cut off
+#define OPTIMIZE_SALT (0x6f7074696d697a65ull) // Keeps the keys apart from the solver's
+
+
+/**
+ * @brief Guess of a set, with the lower bound of its cost.
+ */
+typedef struct
+{
+    int guess;
+    long bound;
+} Candidate;
+
+/**
+ * @brief State of an optimization, shared by the workers.
+ */
+typedef struct
+{
+    const Partition *p;
+    Transposition *table;
+    int *answerGuess; // Guess index of each answer
+    long *floors;     // floors[m]: lower bound of the cost of m answers
+    FILE *cache;      // Append-only cache file, or NULL
+    long searched;    // Updated atomically
+
+    pthread_mutex_t lock; // Guards the cache file and the fields below
+
+    // First guesses of the root, taken in order by the workers
+    const int *root;
+    int n;
+    Candidate *candidates;
+    int count;
+    int next;
+    long best;
+    int bestGuess;
+    long *bound; // Best cost of the root over every shard, or NULL
+} Optimizer;
+
+/**
+ * @brief First guesses of the root dealt to shards in turn.
+ */
+typedef struct
+{
+    Optimizer *o;
+    int threads;
+    int shards;
+} RootShards;
+
+/**
+ * @brief Best first guess found by a shard.
+ */
+typedef struct
+{
+    long best;
+    int guess;
+    long searched;
+} RootReport;
+
+/**
+ * @brief Pattern buckets of the first guess dealt to shards.
+ */
+typedef struct
+{
+    Optimizer *o;
+    int threads;
+    int first;
+    int *buckets;
+    int start[PATTERN_COUNT + 1];
+    int owner[PATTERN_SOLVED];
+    int tree; // 1 if the shards write their part of the tree
+} BucketShards;
+
+/**
+ * @brief A pattern bucket of a forced first guess, solved by its own task.
+ */
+typedef struct
+{
+    Optimizer *o;
+    int *answers;
+    int n;
+    long cost;
+} Bucket;
+
+
+static long solve(Optimizer *o, const int *answers, int n, long beta,
+                  int *guess);
+static long evaluate(Optimizer *o, const int *answers, int n, int guess,
+                     long beta);
+static int listCandidates(Optimizer *o, const int *answers, int n, long beta,
+                          Candidate **candidates, long *dropped);
+static int perfectGuess(Optimizer *o, const int *answers, int n);
+static int splitBuckets(const Partition *p, int guess, const int *answers,
+                        int n, int *buckets, int *start);
+static int compareCandidates(const void *a, const void *b);
+static void searchRoot(Scheduler *scheduler, void *arg);
+static void solveBucket(Scheduler *scheduler, void *arg);
+static long forcedRoot(Optimizer *o, Scheduler *scheduler, const int *answers,
+                       int n, int guess);
+static int searchShards(Optimizer *o, int threads, int shards);
+static void searchShard(int shard, FILE *out, void *context);
+static long bucketShards(Optimizer *o, int threads, int shards,
+                         const int *answers, int n, int first,
+                         OptimizeResult *result, FILE *tree);
+static void bucketShard(int shard, FILE *out, void *context);
+static void lowerBound(long *bound, long value);
+static void remember(Optimizer *o, uint64_t key, int n, int guess, long cost);
+static uint64_t setKey(Optimizer *o, const int *answers, int n);
+static void openCache(Optimizer *o, char *cache_file, OptimizeResult *result);
+static void walk(Optimizer *o, const int *answers, int n, int depth, int guess,
+                 char (*path)[WORD_BYTES], int *patterns,
+                 OptimizeResult *result, FILE *tree);
+static void expectNotNull(void *p);
+
+
+OptimizeResult optimizeRun(const Partition *p, char *first_guess, int threads,
+                           int shards, Transposition *table, char *cache_file,
+                           FILE *tree)
+{
+    OptimizeResult result;
+    Optimizer o;
+    int Na = partitionNbAnswers(p);
+    int a;
+
+    if (Na == 0) {
+        fprintf(stderr, "Le fichier des réponses ne contient aucun mot.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    memset(&result, 0, sizeof(result));
+    result.games = Na;
+
+    o.p = p;
+    o.table = table;
+    o.cache = NULL;
+    o.searched = 0;
+    o.bound = NULL;
+    pthread_mutex_init(&o.lock, NULL);
+
+    o.answerGuess = memoryAlloc(MEMORY_OPTIMIZE, Na * sizeof(int));
+    o.floors = memoryAlloc(MEMORY_OPTIMIZE, (Na + 1) * sizeof(long));
+    int *answers = memoryAlloc(MEMORY_OPTIMIZE, Na * sizeof(int));
+    expectNotNull(o.answerGuess);
+    expectNotNull(o.floors);
+    expectNotNull(answers);
+
+    for (a = 0; a < Na; a++) {
+        answers[a] = a;
+        o.answerGuess[a] = partitionFindGuess(p, partitionAnswer(p, a));
+        if (o.answerGuess[a] < 0) {
+            fprintf(stderr, "La réponse %s n'est pas un mot accepté.\n", partitionAnswer(p, a));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // One answer found by the first guess, 242 by the second, 242^2 by the third...
+    for (int m = 0; m <= Na; m++) {
+        long left = m, width = 1;
+        o.floors[m] = 0;
+        for (int d = 1; left > 0; d++, width *= PATTERN_COUNT - 1) {
+            long k = left < width ? left : width;
+            o.floors[m] += d * k;
+            left -= k;
+        }
+    }
+
+    if (cache_file)
+        openCache(&o, cache_file, &result);
+
+    int first = -1;
+    if (first_guess) {
+        first = partitionFindGuess(p, first_guess);
+        if (first < 0) {
+            fprintf(stderr, "Le premier mot choisi n'existe pas.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (shards > 1 && Na > 2) {
+        if (first < 0) {
+            long dropped;
+            o.root = answers;
+            o.n = Na;
+            o.count = listCandidates(&o, answers, Na, OPTIMIZE_INFINITY,
+                                     &o.candidates, &dropped);
+            first = searchShards(&o, threads, shards);
+            remember(&o, setKey(&o, answers, Na), Na, first, o.best);
+            memoryFree(o.candidates);
+        }
+
+        strcpy(result.guess, partitionGuess(p, first));
+        result.guesses = bucketShards(&o, threads, shards, answers, Na, first,
+                                      &result, tree);
+        result.searched = o.searched;
+
+        if (o.cache)
+            fclose(o.cache);
+        pthread_mutex_destroy(&o.lock);
+        memoryFree(o.answerGuess);
+        memoryFree(o.floors);
+        memoryFree(answers);
+
+        return result;
+    }
+
+    Scheduler *scheduler = schedulerCreate(threads);
+
+    if (first >= 0) {
+        result.guesses = forcedRoot(&o, scheduler, answers, Na, first);
+    } else if (Na <= 2) {
+        result.guesses = solve(&o, answers, Na, OPTIMIZE_INFINITY, &first);
+    } else {
+        long dropped;
+        o.root = answers;
+        o.n = Na;
+        o.count = listCandidates(&o, answers, Na, OPTIMIZE_INFINITY,
+                                 &o.candidates, &dropped);
+        o.next = 0;
+        o.best = OPTIMIZE_INFINITY;
+        o.bestGuess = -1;
+
+        for (int t = 0; t < threads; t++)
+            schedulerSpawn(scheduler, searchRoot, &o);
+        schedulerWait(scheduler);
+
+        first = o.bestGuess;
+        result.guesses = o.best;
+        remember(&o, setKey(&o, answers, Na), Na, first, o.best);
+        memoryFree(o.candidates);
+    }
+
+    schedulerFree(scheduler);
+
+    strcpy(result.guess, partitionGuess(p, first));
+    result.searched = o.searched;
+
+    // The tree follows the memoized decisions, searching again those evicted
+    char path[OPTIMIZE_MAX_GUESSES][WORD_BYTES];
+    int patterns[OPTIMIZE_MAX_GUESSES];
+    walk(&o, answers, Na, 0, first, path, patterns, &result, tree);
+
+    if (o.cache)
+        fclose(o.cache);
+    pthread_mutex_destroy(&o.lock);
+    memoryFree(o.answerGuess);
+    memoryFree(o.floors);
+    memoryFree(answers);
+
+    return result;
+}
+
+
+/**
+ * @brief Minimal cost of a set: the total number of guesses needed to find
+ * each of its answers.
+ *
+ * @param beta Cost to beat: a search which cannot go below it is cut off.
+ * @param guess Filled with the best guess when the cost is exact.
+ *
+ * @return the exact cost if lower than `beta`, otherwise a lower bound of
+ * it, at least `beta`.
+ */
+static long solve(Optimizer *o, const int *answers, int n, long beta,
+                  int *guess)
+{
+    if (n <= 2) {
+        *guess = o->answerGuess[answers[0]];
+        return 2 * n - 1;
+    }
+    if (o->floors[n] >= beta)
+        return o->floors[n];
+
+    uint64_t key = setKey(o, answers, n);
+    double cost;
+    if (transpositionLookup(o->table, key, n, guess, &cost)
+        && (*guess >= 0 || (long)cost >= beta))
+        return (long)cost;
+
+    __atomic_add_fetch(&o->searched, 1, __ATOMIC_RELAXED);
+
+    // Nothing can do better than an answer splitting the others apart
+    *guess = perfectGuess(o, answers, n);
+    if (*guess >= 0) {
+        remember(o, key, n, *guess, o->floors[n]);
+        return o->floors[n];
+    }
+
+    Candidate *candidates;
+    long lowest;
+    int count = listCandidates(o, answers, n, beta, &candidates, &lowest);
+    long best = beta;
+    *guess = -1;
+
+    for (int c = 0; c < count; c++) {
+        if (candidates[c].bound >= best) {
+            if (candidates[c].bound < lowest)
+                lowest = candidates[c].bound;
+            break;
+        }
+
+        long total = evaluate(o, answers, n, candidates[c].guess, best);
+        if (total < best) {
+            best = total;
+            *guess = candidates[c].guess;
+        } else if (total < lowest) {
+            lowest = total;
+        }
+    }
+
+    memoryFree(candidates);
+
+    if (*guess >= 0) {
+        remember(o, key, n, *guess, best);
+        return best;
+    }
+
+    remember(o, key, n, -1, lowest);
+    return lowest;
+}
+
+
+/**
+ * @brief Cost of a set when a guess is played first: one guess per answer
+ * plus the cost of each pattern bucket. The largest buckets are solved
+ * first, and the others are cut off once `beta` cannot be beaten.
+ *
+ * @return the exact cost if lower than `beta`, otherwise a lower bound of
+ * it, at least `beta`.
+ */
+static long evaluate(Optimizer *o, const int *answers, int n, int guess,
+                     long beta)
+{
+    int start[PATTERN_COUNT + 1];
+    int order[PATTERN_COUNT];
+    int nbBuckets = 0;
+    int i, k, unused;
+
+    int *buckets = memoryAlloc(MEMORY_OPTIMIZE, n * sizeof(int));
+    expectNotNull(buckets);
+    splitBuckets(o->p, guess, answers, n, buckets, start);
+
+    long cost = n, rest = 0;
+    for (k = 0; k < PATTERN_SOLVED; k++) {
+        int size = start[k + 1] - start[k];
+        if (size == 0)
+            continue;
+        rest += o->floors[size];
+        for (i = nbBuckets++; i > 0 && start[order[i - 1] + 1] - start[order[i - 1]] < size; i--)
+            order[i] = order[i - 1];
+        order[i] = k;
+    }
+
+    for (i = 0; i < nbBuckets && cost + rest < beta; i++) {
+        k = order[i];
+        int size = start[k + 1] - start[k];
+        rest -= o->floors[size];
+        cost += solve(o, buckets + start[k], size, beta - cost - rest, &unused);
+    }
+
+    memoryFree(buckets);
+
+    return cost + rest;
+}
+
+
+/**
+ * @brief Lists the guesses of a set whose lower bound beats `beta`, by
+ * increasing lower bound then index. Guesses leaving every answer in the
+ * same bucket are left out.
+ *
+ * @param candidates Filled with the guesses, to free with memoryFree.
+ * @param dropped Filled with the lowest bound of the guesses left out
+ * (OPTIMIZE_INFINITY if none).
+ *
+ * @return the number of guesses listed.
+ */
+static int listCandidates(Optimizer *o, const int *answers, int n, long beta,
+                          Candidate **candidates, long *dropped)
+{
+    int histogram[PATTERN_COUNT] = {0};
+    int Ng = partitionNbGuesses(o->p);
+    int count = 0;
+    int i;
+
+    unsigned char *codes = memoryAlloc(MEMORY_OPTIMIZE, n);
+    *candidates = memoryAlloc(MEMORY_OPTIMIZE, Ng * sizeof(Candidate));
+    expectNotNull(codes);
+    expectNotNull(*candidates);
+    *dropped = OPTIMIZE_INFINITY;
+
+    for (int g = 0; g < Ng; g++) {
+        long bound = n;
+        int useless = 0;
+
+        for (i = 0; i < n; i++) {
+            codes[i] = (unsigned char)partitionPattern(o->p, g, answers[i]);
+            histogram[codes[i]]++;
+        }
+
+        // Each bucket is counted once, when its counter is reset
+        for (i = 0; i < n; i++) {
+            int size = histogram[codes[i]];
+            if (size == 0)
+                continue;
+            if (codes[i] != PATTERN_SOLVED) {
+                bound += o->floors[size];
+                useless |= size == n;
+            }
+            histogram[codes[i]] = 0;
+        }
+
+        if (useless)
+            continue;
+        if (bound >= beta) {
+            if (bound < *dropped)
+                *dropped = bound;
+            continue;
+        }
+
+        (*candidates)[count].guess = g;
+        (*candidates)[count].bound = bound;
+        count++;
+    }
+
+    memoryFree(codes);
+    qsort(*candidates, count, sizeof(Candidate), compareCandidates);
+
+    return count;
+}
+
+
+/**
+ * @brief Looks for an answer of the set splitting the others into
+ * buckets of one answer.
+ *
+ * @return its guess index, or -1 if there is none.
+ */
+static int perfectGuess(Optimizer *o, const int *answers, int n)
+{
+    unsigned char seen[PATTERN_COUNT];
+
+    if (n > PATTERN_COUNT)
+        return -1;
+
+    for (int i = 0; i < n; i++) {
+        int g = o->answerGuess[answers[i]];
+        int j;
+
+        memset(seen, 0, sizeof(seen));
+        for (j = 0; j < n; j++) {
+            int code = partitionPattern(o->p, g, answers[j]);
+            if (seen[code])
+                break;
+            seen[code] = 1;
+        }
+
+        if (j == n)
+            return g;
+    }
+
+    return -1;
+}
+
+
+/**
+ * @brief Counting sort of a set by the patterns of a guess: the answers of
+ * pattern k are stored in buckets[start[k]] to buckets[start[k + 1] - 1].
+ *
+ * @param start Array of PATTERN_COUNT + 1 offsets, overwritten.
+ *
+ * @return the number of answers.
+ */
+static int splitBuckets(const Partition *p, int guess, const int *answers,
+                        int n, int *buckets, int *start)
+{
+    int next[PATTERN_COUNT];
+    int i, k;
+
+    memset(start, 0, (PATTERN_COUNT + 1) * sizeof(int));
+    for (i = 0; i < n; i++)
+        start[partitionPattern(p, guess, answers[i]) + 1]++;
+    for (k = 0; k < PATTERN_COUNT; k++)
+        start[k + 1] += start[k];
+
+    memcpy(next, start, sizeof(next));
+    for (i = 0; i < n; i++)
+        buckets[next[partitionPattern(p, guess, answers[i])]++] = answers[i];
+
+    return n;
+}
+
+
+static int compareCandidates(const void *a, const void *b)
+{
+    const Candidate *x = a, *y = b;
+
+    if (x->bound != y->bound)
+        return x->bound < y->bound ? -1 : 1;
+
+    return x->guess - y->guess;
+}
+
+
+/**
+ * @brief Worker of the root: takes the next first guess in order and
+ * searches it against the best one found by all the workers.
+ */
+static void searchRoot(Scheduler *scheduler, void *arg)
+{
+    Optimizer *o = arg;
+    (void)scheduler;
+
+    while (1) {
+        int c = __atomic_fetch_add(&o->next, 1, __ATOMIC_RELAXED);
+        if (c >= o->count)
+            return;
+
+        pthread_mutex_lock(&o->lock);
+        long best = o->best;
+        pthread_mutex_unlock(&o->lock);
+        if (o->bound && __atomic_load_n(o->bound, __ATOMIC_RELAXED) < best)
+            best = __atomic_load_n(o->bound, __ATOMIC_RELAXED);
+
+        // The next ones are not better bounded
+        if (o->candidates[c].bound >= best)
+            return;
+
+        long total = evaluate(o, o->root, o->n, o->candidates[c].guess, best);
+
+        // Below `best`, the cost is exact
+        pthread_mutex_lock(&o->lock);
+        if (total < best && total < o->best) {
+            o->best = total;
+            o->bestGuess = o->candidates[c].guess;
+            if (o->bound)
+                lowerBound(o->bound, total);
+            if (DEBUG)
+                printf("DEBUG MODE: (%s : %ld essais)\n",
+                       partitionGuess(o->p, o->bestGuess), total);
+        }
+        pthread_mutex_unlock(&o->lock);
+    }
+}
+
+
+static void solveBucket(Scheduler *scheduler, void *arg)
+{
+    Bucket *bucket = arg;
+    int unused;
+    (void)scheduler;
+
+    bucket->cost = solve(bucket->o, bucket->answers, bucket->n,
+                         OPTIMIZE_INFINITY, &unused);
+}
+
+
+/**
+ * @brief Cost of a set with a forced first guess, its buckets being solved
+ * in parallel.
+ */
+static long forcedRoot(Optimizer *o, Scheduler *scheduler, const int *answers,
+                       int n, int guess)
+{
+    int start[PATTERN_COUNT + 1];
+    Bucket tasks[PATTERN_SOLVED];
+    long cost = n;
+
+    int *buckets = memoryAlloc(MEMORY_OPTIMIZE, n * sizeof(int));
+    expectNotNull(buckets);
+    splitBuckets(o->p, guess, answers, n, buckets, start);
+
+    for (int k = 0; k < PATTERN_SOLVED; k++) {
+        tasks[k].o = o;
+        tasks[k].answers = buckets + start[k];
+        tasks[k].n = start[k + 1] - start[k];
+        tasks[k].cost = 0;
+        if (tasks[k].n > 0)
+            schedulerSpawn(scheduler, solveBucket, &tasks[k]);
+    }
+    schedulerWait(scheduler);
+
+    for (int k = 0; k < PATTERN_SOLVED; k++)
+        cost += tasks[k].cost;
+
+    memoryFree(buckets);
+
+    return cost;
+}
+
+
+/**
+ * @brief Searches the first guesses of the root in shards, each taking
+ * every shards-th one in order so that all get some of the best bounded.
+ *
+ * @return the best first guess, its cost being left in o->best.
+ */
+static int searchShards(Optimizer *o, int threads, int shards)
+{
+    RootShards job = {o, threads, shards};
+
+    o->bound = memoryMapShared(MEMORY_OPTIMIZE, sizeof(long));
+    expectNotNull(o->bound);
+    *o->bound = OPTIMIZE_INFINITY;
+
+    FILE **files = shardRun(shards, searchShard, &job);
+
+    o->best = OPTIMIZE_INFINITY;
+    o->bestGuess = -1;
+    for (int s = 0; s < shards; s++) {
+        RootReport report;
+        if (fread(&report, sizeof(report), 1, files[s]) != 1) {
+            fprintf(stderr, "Le résultat du shard %d n'a pas pu être lu.\n", s);
+            exit(EXIT_FAILURE);
+        }
+
+        o->searched += report.searched;
+        if (report.guess >= 0 && report.best < o->best) {
+            o->best = report.best;
+            o->bestGuess = report.guess;
+        }
+    }
+
+    shardClose(files, shards);
+    memoryUnmapShared(o->bound);
+    o->bound = NULL;
+
+    return o->bestGuess;
+}
+
+
+static void searchShard(int shard, FILE *out, void *context)
+{
+    RootShards *job = context;
+    Optimizer *o = job->o;
+    long searched = o->searched;
+
+    int count = 0;
+    for (int c = shard; c < o->count; c += job->shards)
+        o->candidates[count++] = o->candidates[c];
+    o->count = count;
+    o->next = 0;
+    o->best = OPTIMIZE_INFINITY;
+    o->bestGuess = -1;
+
+    Scheduler *scheduler = schedulerCreate(job->threads);
+    for (int t = 0; t < job->threads; t++)
+        schedulerSpawn(scheduler, searchRoot, o);
+    schedulerWait(scheduler);
+    schedulerFree(scheduler);
+
+    RootReport report = {o->best, o->bestGuess, o->searched - searched};
+    fwrite(&report, sizeof(report), 1, out);
+}
+
+
+/**
+ * @brief Cost of a set with a forced first guess, its buckets being dealt
+ * to shards. Counts the guesses of every answer, and writes the tree.
+ */
+static long bucketShards(Optimizer *o, int threads, int shards,
+                         const int *answers, int n, int first,
+                         OptimizeResult *result, FILE *tree)
+{
+    BucketShards job;
+    int sizes[PATTERN_SOLVED];
+    long cost = n;
+
+    job.o = o;
+    job.threads = threads;
+    job.first = first;
+    job.tree = tree != NULL;
+    job.buckets = memoryAlloc(MEMORY_OPTIMIZE, n * sizeof(int));
+    expectNotNull(job.buckets);
+    splitBuckets(o->p, first, answers, n, job.buckets, job.start);
+
+    for (int k = 0; k < PATTERN_SOLVED; k++)
+        sizes[k] = job.start[k + 1] - job.start[k];
+    shardDeal(sizes, PATTERN_SOLVED, shards, job.owner);
+
+    FILE **files = shardRun(shards, bucketShard, &job);
+
+    // The first guess, when it is the answer
+    if (job.start[PATTERN_COUNT] > job.start[PATTERN_SOLVED]) {
+        char path[1][WORD_BYTES];
+        int patterns[1] = {PATTERN_SOLVED};
+        strcpy(path[0], partitionGuess(o->p, first));
+        result->counts[1]++;
+        if (tree)
+            decisionTreeWritePath(tree, path, patterns, 1);
+    }
+
+    for (int s = 0; s < shards; s++) {
+        OptimizeResult part;
+        if (fread(&part, sizeof(part), 1, files[s]) != 1) {
+            fprintf(stderr, "Le résultat du shard %d n'a pas pu être lu.\n", s);
+            exit(EXIT_FAILURE);
+        }
+
+        cost += part.guesses;
+        o->searched += part.searched;
+        for (int k = 0; k <= OPTIMIZE_MAX_GUESSES; k++)
+            result->counts[k] += part.counts[k];
+
+        // Followed by the shard's part of the tree
+        char buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), files[s])) > 0)
+            if (tree)
+                fwrite(buffer, 1, read, tree);
+    }
+
+    shardClose(files, shards);
+    memoryFree(job.buckets);
+
+    return cost;
+}
+
+
+static void bucketShard(int shard, FILE *out, void *context)
+{
+    BucketShards *job = context;
+    Optimizer *o = job->o;
+    Bucket tasks[PATTERN_SOLVED];
+    OptimizeResult part;
+    long searched = o->searched;
+
+    memset(&part, 0, sizeof(part));
+
+    Scheduler *scheduler = schedulerCreate(job->threads);
+    for (int k = 0; k < PATTERN_SOLVED; k++) {
+        tasks[k].o = o;
+        tasks[k].answers = job->buckets + job->start[k];
+        tasks[k].n = job->owner[k] == shard ? job->start[k + 1] - job->start[k] : 0;
+        tasks[k].cost = 0;
+        if (tasks[k].n > 0)
+            schedulerSpawn(scheduler, solveBucket, &tasks[k]);
+    }
+    schedulerWait(scheduler);
+    schedulerFree(scheduler);
+
+    FILE *tree = NULL;
+    if (job->tree) {
+        tree = tmpfile();
+        expectNotNull(tree);
+    }
+
+    char path[OPTIMIZE_MAX_GUESSES][WORD_BYTES];
+    int patterns[OPTIMIZE_MAX_GUESSES];
+    strcpy(path[0], partitionGuess(o->p, job->first));
+
+    for (int k = 0; k < PATTERN_SOLVED; k++) {
+        if (tasks[k].n == 0)
+            continue;
+        part.guesses += tasks[k].cost;
+        patterns[0] = k;
+        walk(o, tasks[k].answers, tasks[k].n, 1, -1, path, patterns, &part, tree);
+    }
+
+    part.searched = o->searched - searched;
+    fwrite(&part, sizeof(part), 1, out);
+
+    if (tree) {
+        char buffer[4096];
+        size_t read;
+        rewind(tree);
+        while ((read = fread(buffer, 1, sizeof(buffer), tree)) > 0)
+            fwrite(buffer, 1, read, out);
+        fclose(tree);
+    }
+}
+
+
+/**
+ * @brief Lowers a bound shared by several processes to `value`.
+ */
+static void lowerBound(long *bound, long value)
+{
+    long current = __atomic_load_n(bound, __ATOMIC_RELAXED);
+
+    while (value < current
+           && !__atomic_compare_exchange_n(bound, &current, value, 1,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+
+/**
+ * @brief Stores the cost of a set (exact with its guess, or a lower bound
+ * with guess -1) in the table, and in the cache file if the set is large
+ * enough.
+ */
+static void remember(Optimizer *o, uint64_t key, int n, int guess, long cost)
+{
+    transpositionStore(o->table, key, n, guess, (double)cost);
+
+    if (o->cache == NULL || n < OPTIMIZE_PERSIST_MIN)
+        return;
+
+    pthread_mutex_lock(&o->lock);
+    fprintf(o->cache, "%016" PRIx64 " %d %s %ld\n", key, n,
+            guess >= 0 ? partitionGuess(o->p, guess) : "-", cost);
+    fflush(o->cache);
+    pthread_mutex_unlock(&o->lock);
+}
+
+
+static uint64_t setKey(Optimizer *o, const int *answers, int n)
+{
+    uint64_t key = OPTIMIZE_SALT;
+
+    for (int i = 0; i < n; i++)
+        key ^= partitionAnswerKey(o->p, 0, answers[i]);
+
+    return key;
+}
+
+
+/**
+ * @brief Loads the results of a cache file into the table, then opens it to
+ * append the new ones. The file starts with a fingerprint of the word
+ * lists, and has one line per set: its key, size, best guess ("-" for a
+ * lower bound) and cost. A line cut by an interruption is ignored.
+ */
+static void openCache(Optimizer *o, char *cache_file, OptimizeResult *result)
+{
+    uint64_t expected = partitionFingerprint(o->p);
+    FILE *f = fopen(cache_file, "r");
+
+    if (f) {
+        uint64_t found, key;
+        char word[WORD_BYTES + 1];
+        long cost;
+        int n;
+
+        if (fscanf(f, "wordle-optimize %" SCNx64 "\n", &found) != 1 || found != expected) {
+            fprintf(stderr, "Le fichier %s a été calculé pour d'autres listes de mots.\n", cache_file);
+            exit(EXIT_FAILURE);
+        }
+
+        while (fscanf(f, "%" SCNx64 " %d %21s %ld\n", &key, &n, word, &cost) == 4) {
+            int guess = strcmp(word, "-") == 0 ? -1 : partitionFindGuess(o->p, word);
+            if (guess < 0 && strcmp(word, "-") != 0)
+                continue;
+            transpositionStore(o->table, key, n, guess, (double)cost);
+            result->loaded++;
+        }
+
+        fclose(f);
+    } else if (errno != ENOENT) {
+        fprintf(stderr, "Le fichier %s n'a pas pu être ouvert: %s\n", cache_file, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    o->cache = fopen(cache_file, "a");
+    if (o->cache == NULL) {
+        fprintf(stderr, "Le fichier %s n'a pas pu être ouvert: %s\n", cache_file, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    if (f == NULL) {
+        fprintf(o->cache, "wordle-optimize %016" PRIx64 "\n", expected);
+        fflush(o->cache);
+    }
+}
+
+
+/**
+ * @brief Plays the strategy on every answer of a set, counting the guesses
+ * and writing the line of each answer to the tree.
+ *
+ * @param guess Guess of the set, or -1 to take the best one.
+ * @param path Guesses played before the set.
+ * @param patterns Patterns they got.
+ */
+static void walk(Optimizer *o, const int *answers, int n, int depth, int guess,
+                 char (*path)[WORD_BYTES], int *patterns,
+                 OptimizeResult *result, FILE *tree)
+{
+    int start[PATTERN_COUNT + 1];
+
+    if (depth == OPTIMIZE_MAX_GUESSES) {
+        fprintf(stderr, "L'arbre dépasse %d essais.\n", OPTIMIZE_MAX_GUESSES);
+        exit(EXIT_FAILURE);
+    }
+
+    if (guess < 0)
+        solve(o, answers, n, OPTIMIZE_INFINITY, &guess);
+
+    int *buckets = memoryAlloc(MEMORY_OPTIMIZE, n * sizeof(int));
+    expectNotNull(buckets);
+    splitBuckets(o->p, guess, answers, n, buckets, start);
+
+    strcpy(path[depth], partitionGuess(o->p, guess));
+
+    for (int k = 0; k < PATTERN_COUNT; k++) {
+        int size = start[k + 1] - start[k];
+        if (size == 0)
+            continue;
+
+        patterns[depth] = k;
+        if (k == PATTERN_SOLVED) {
+            result->counts[depth + 1]++;
+            if (tree)
+                decisionTreeWritePath(tree, path, patterns, depth + 1);
+        } else {
+            walk(o, buckets + start[k], size, depth + 1, -1, path, patterns,
+                 result, tree);
+        }
+    }
+
+    memoryFree(buckets);
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
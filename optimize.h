@@ -0,0 +1,70 @@
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+
+#include "partition.h"
+#include "transposition.h"
+#include "wordle.h"
+
+#include <stdio.h>
+
+#define OPTIMIZE_MAX_GUESSES (32) // Deepest game of a tree
+#define OPTIMIZE_PERSIST_MIN (8)  // Smallest sets whose results are saved to the cache file
+
+/**
+ * @brief Optimal strategy found for a set of possible answers.
+ */
+typedef struct OptimizeResult_t
+{
+    int games;                   // Number of answers
+    long guesses;                // Minimal total number of guesses over the answers
+    int counts[OPTIMIZE_MAX_GUESSES + 1]; // counts[k]: answers found in k guesses
+    char guess[WORD_BYTES];      // First guess of the strategy
+    long loaded;                 // Results read back from the cache file
+    long searched;               // Sets searched during this run
+} OptimizeResult;
+
+/**
+ * @brief Computes the strategy minimizing the total number of guesses
+ * needed to find every possible answer, and writes its decision tree.
+ *
+ * The minimal cost of a set is found by dynamic programming: the set's size
+ * (one guess per answer) plus, for the best guess, the cost of each of its
+ * pattern buckets. Costs are memoized in the table, keyed by the set. A
+ * guess is only searched if an admissible lower bound of its cost (every
+ * bucket solved as fast as 242 patterns per guess allow) beats the best
+ * guess so far, guesses are searched by increasing lower bound, and the
+ * buckets of a guess are abandoned as soon as their costs and the bounds
+ * of the others cannot beat it anymore. The first guesses are searched in
+ * parallel by the scheduler's workers.
+ *
+ * With several shards, the work is spread over processes sharing the
+ * table: the first guesses to search are dealt to the shards in turn, the
+ * best cost found so far being shared to cut them off, then the pattern
+ * buckets of the best one are dealt to the shards, largest first, and each
+ * shard writes the part of the tree of its buckets. The engine and the
+ * table should then be in shared mappings (see partitionMapShared and
+ * transpositionCreateShared), so that memory does not grow with the
+ * number of shards.
+ *
+ * Every cost and lower bound proven for a set of at least
+ * OPTIMIZE_PERSIST_MIN answers is appended to the cache file, and the
+ * results already in it are loaded first, so that an interrupted run
+ * resumes where it stopped.
+ *
+ * @param p The engine, with at least one answer. Every answer must be an
+ * accepted guess.
+ * @param first_guess forced first guess (NULL to search the best one).
+ * @param threads number of worker threads (of each shard).
+ * @param shards number of processes.
+ * @param table Table memoizing the costs.
+ * @param cache_file Path to the cache file (NULL for none).
+ * @param tree Stream the decision tree is written to (NULL for none), in
+ * the format read by decisionTreeLoad.
+ *
+ * @return the strategy found.
+ */
+OptimizeResult optimizeRun(const Partition *p, char *first_guess, int threads,
+                           int shards, Transposition *table, char *cache_file,
+                           FILE *tree);
+
+#endif
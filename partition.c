@@ -0,0 +1,625 @@
+#include "partition.h"
+#include "wordle.h"
+#include "dict.h"
+#include "memory.h"
+#include "alphabet.h"
+#include "kernel.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+
+
+struct Partition_t {
+    char (*answers)[WORD_BYTES];      // Possible answers, in UTF-8
+    char (*guesses)[WORD_BYTES];      // Accepted guesses, in UTF-8
+    unsigned char (*answerLetters)[WORD_LENGTH]; // Answers as letter indices
+    unsigned char (*guessLetters)[WORD_LENGTH];  // Guesses as letter indices
+    Alphabet *alphabet;               // Letters of both lists
+    int Na;                           // Number of possible answers
+    int Ng;                           // Number of accepted guesses
+    Dict *index;                      // Guess -> its index in `guesses`
+    unsigned char *matrix;            // Ng x Na pattern codes, or NULL
+    int owners;                       // Number of partitionFree expected
+
+    // Inverted index in compressed sparse rows, or NULL: the answers giving
+    // pattern c with guess g are bucket[start[g * (PATTERN_COUNT + 1) + c]]
+    // up to bucket[start[g * (PATTERN_COUNT + 1) + c + 1]], sorted.
+    unsigned short *bucket;
+    unsigned *start;
+
+    // Shared mapping holding the matrix and the index, or NULL if they
+    // are on the heap
+    void *segment;
+};
+
+
+static char (*readWords(char *file, Alphabet *alphabet, int *count,
+                        unsigned char (**letters)[WORD_LENGTH],
+                        PartitionError *error))[WORD_BYTES];
+static int intersectBucket(const unsigned short *list, int m, int *answers,
+                           int n);
+static int lowerBound(const int *answers, int lo, int hi, int value);
+static void expectNotNull(void *p);
+
+
+Partition *partitionCreate(char *answers_file, char *guesses_file)
+{
+    PartitionError error;
+    Partition *p = partitionLoad(answers_file, guesses_file, &error);
+
+    if (p)
+        return p;
+
+    partitionReportError(&error, stderr);
+    exit(EXIT_FAILURE);
+}
+
+
+void partitionReportError(const PartitionError *error, FILE *out)
+{
+    switch (error->status) {
+    case PARTITION_OK:
+        break;
+    case PARTITION_FILE_ERROR:
+        fprintf(out, "Le fichier %s n'a pas pu être lu: %s\n", error->file, strerror(error->error));
+        break;
+    case PARTITION_INVALID_WORD:
+        fprintf(out, "Le mot %s du fichier %s n'est pas composé d'exactement %d lettres.\n",
+                error->word, error->file, WORD_LENGTH);
+        break;
+    default:
+        fprintf(out, "Le fichier %s utilise plus de %d lettres différentes.\n",
+                error->file, ALPHABET_MAX_LETTERS);
+    }
+}
+
+
+Partition *partitionLoad(char *answers_file, char *guesses_file,
+                         PartitionError *error)
+{
+    Partition *p = memoryAlloc(MEMORY_PARTITION, sizeof(Partition));
+    expectNotNull(p);
+
+    error->status = PARTITION_OK;
+    p->alphabet = alphabetCreate();
+    p->answers = readWords(answers_file, p->alphabet, &p->Na, &p->answerLetters, error);
+    p->guesses = p->answers ? readWords(guesses_file, p->alphabet, &p->Ng, &p->guessLetters, error) : NULL;
+
+    if (p->guesses == NULL) {
+        if (p->answers) {
+            memoryFree(p->answers);
+            memoryFree(p->answerLetters);
+        }
+        alphabetFree(p->alphabet);
+        memoryFree(p);
+        return NULL;
+    }
+
+    p->matrix = NULL;
+    p->owners = 1;
+    p->bucket = NULL;
+    p->start = NULL;
+    p->segment = NULL;
+
+    p->index = dictCreate(2 * p->Ng + 1);
+    for (int g = 0; g < p->Ng; g++)
+        dictInsert(p->index, p->guesses[g], g);
+
+    return p;
+}
+
+
+Partition *partitionReload(const Partition *p, char *answers_file,
+                           char *guesses_file, PartitionChanges *changes,
+                           PartitionError *error)
+{
+    // Letter indices may differ, but patterns only compare letters
+    Partition *q = partitionLoad(answers_file, guesses_file, error);
+    if (q == NULL)
+        return NULL;
+
+    // Index of each word in the old lists, or -1 if it was added
+    int *oldAnswer = memoryAlloc(MEMORY_PARTITION, q->Na * sizeof(int));
+    int *oldGuess = memoryAlloc(MEMORY_PARTITION, q->Ng * sizeof(int));
+    expectNotNull(oldAnswer);
+    expectNotNull(oldGuess);
+
+    Dict *answers = dictCreate(2 * p->Na + 1);
+    for (int a = 0; a < p->Na; a++)
+        dictInsert(answers, p->answers[a], a);
+
+    int keptAnswers = 0, keptGuesses = 0;
+    for (int a = 0; a < q->Na; a++) {
+        oldAnswer[a] = dictContains(answers, q->answers[a])
+                     ? (int)dictSearch(answers, q->answers[a]) : -1;
+        keptAnswers += oldAnswer[a] >= 0;
+    }
+    for (int g = 0; g < q->Ng; g++) {
+        oldGuess[g] = partitionFindGuess(p, q->guesses[g]);
+        keptGuesses += oldGuess[g] >= 0;
+    }
+    dictFree(answers);
+
+    changes->addedAnswers = q->Na - keptAnswers;
+    changes->removedAnswers = p->Na - keptAnswers;
+    changes->addedGuesses = q->Ng - keptGuesses;
+    changes->removedGuesses = p->Ng - keptGuesses;
+
+    if (p->matrix && (size_t)q->Ng * q->Na <= PARTITION_TABLES_MAX_BYTES) {
+        q->matrix = memoryAlloc(MEMORY_PARTITION, (size_t)q->Ng * q->Na);
+        expectNotNull(q->matrix);
+
+        unsigned char *row = q->matrix;
+        for (int g = 0; g < q->Ng; g++, row += q->Na) {
+            const unsigned char *old = oldGuess[g] < 0 ? NULL
+                                     : p->matrix + (size_t)oldGuess[g] * p->Na;
+            for (int a = 0; a < q->Na; a++)
+                row[a] = old && oldAnswer[a] >= 0 ? old[oldAnswer[a]]
+                       : wordlePatternLetters(q->guessLetters[g], q->answerLetters[a]);
+        }
+    }
+
+    if (p->bucket)
+        partitionBuildIndex(q);
+
+    memoryFree(oldAnswer);
+    memoryFree(oldGuess);
+
+    return q;
+}
+
+
+Partition *partitionShare(Partition *p)
+{
+    __atomic_add_fetch(&p->owners, 1, __ATOMIC_SEQ_CST);
+    return p;
+}
+
+
+void partitionFree(Partition *p)
+{
+    if (__atomic_sub_fetch(&p->owners, 1, __ATOMIC_SEQ_CST) > 0)
+        return;
+
+    memoryFree(p->answers);
+    memoryFree(p->guesses);
+    memoryFree(p->answerLetters);
+    memoryFree(p->guessLetters);
+    alphabetFree(p->alphabet);
+    if (p->segment) {
+        memoryUnmapShared(p->segment);
+    } else {
+        memoryFree(p->matrix);
+        memoryFree(p->bucket);
+        memoryFree(p->start);
+    }
+    dictFree(p->index);
+    memoryFree(p);
+}
+
+
+int partitionBuildMatrix(Partition *p)
+{
+    if (p->matrix)
+        return 1;
+
+    if ((size_t)p->Ng * p->Na > PARTITION_TABLES_MAX_BYTES)
+        return 0;
+
+    p->matrix = memoryAlloc(MEMORY_PARTITION, (size_t)p->Ng * p->Na);
+    expectNotNull(p->matrix);
+
+    // The kernel reads the answers by columns
+    unsigned char *columns = memoryAlloc(MEMORY_PARTITION, (size_t)WORD_LENGTH * p->Na);
+    expectNotNull(columns);
+    for (int a = 0; a < p->Na; a++)
+        for (int i = 0; i < WORD_LENGTH; i++)
+            columns[(size_t)i * p->Na + a] = p->answerLetters[a][i];
+
+    unsigned char *row = p->matrix;
+    for (int g = 0; g < p->Ng; g++, row += p->Na)
+        kernelPatterns(p->guessLetters[g], columns, p->Na, p->Na, row);
+
+    memoryFree(columns);
+
+    return 1;
+}
+
+
+void partitionBuildIndex(Partition *p)
+{
+    // Answer indices are stored on 16 bits, next to a byte of the matrix
+    if (p->bucket || p->Na > USHRT_MAX + 1
+        || (size_t)p->Ng * p->Na * 3 > PARTITION_TABLES_MAX_BYTES)
+        return;
+
+    partitionBuildMatrix(p);
+
+    size_t rows = (size_t)p->Ng * (PATTERN_COUNT + 1);
+    p->start = memoryCalloc(MEMORY_PARTITION, rows + 1, sizeof(unsigned));
+    expectNotNull(p->start);
+    p->bucket = memoryAlloc(MEMORY_PARTITION, (size_t)p->Ng * p->Na * sizeof(unsigned short));
+    expectNotNull(p->bucket);
+
+    // Counting the size of each bucket, then turning counts into offsets
+    const unsigned char *row = p->matrix;
+    for (int g = 0; g < p->Ng; g++, row += p->Na)
+        for (int a = 0; a < p->Na; a++)
+            p->start[(size_t)g * (PATTERN_COUNT + 1) + row[a] + 1]++;
+
+    for (size_t r = 1; r <= rows; r++)
+        p->start[r] += p->start[r - 1];
+
+    // Filling in increasing answer order keeps every bucket sorted
+    unsigned *next = memoryAlloc(MEMORY_PARTITION, PATTERN_COUNT * sizeof(unsigned));
+    expectNotNull(next);
+
+    row = p->matrix;
+    for (int g = 0; g < p->Ng; g++, row += p->Na) {
+        memcpy(next, p->start + (size_t)g * (PATTERN_COUNT + 1),
+               PATTERN_COUNT * sizeof(unsigned));
+        for (int a = 0; a < p->Na; a++)
+            p->bucket[next[row[a]]++] = (unsigned short)a;
+    }
+
+    memoryFree(next);
+}
+
+
+void partitionMapShared(Partition *p)
+{
+    if (p->segment || p->matrix == NULL)
+        return;
+
+    size_t matrix = (size_t)p->Ng * p->Na;
+    size_t start = p->start ? ((size_t)p->Ng * (PATTERN_COUNT + 1) + 1) * sizeof(unsigned) : 0;
+    size_t bucket = p->bucket ? matrix * sizeof(unsigned short) : 0;
+
+    // Widest elements first, so that each table stays aligned
+    p->segment = memoryMapShared(MEMORY_PARTITION, start + bucket + matrix);
+    expectNotNull(p->segment);
+    char *next = p->segment;
+
+    if (p->start) {
+        memcpy(next, p->start, start);
+        memoryFree(p->start);
+        p->start = (unsigned *)next;
+        next += start;
+    }
+    if (p->bucket) {
+        memcpy(next, p->bucket, bucket);
+        memoryFree(p->bucket);
+        p->bucket = (unsigned short *)next;
+        next += bucket;
+    }
+    memcpy(next, p->matrix, matrix);
+    memoryFree(p->matrix);
+    p->matrix = (unsigned char *)next;
+
+    memorySealShared(p->segment);
+}
+
+
+int partitionNbAnswers(const Partition *p)
+{
+    return p->Na;
+}
+
+
+int partitionNbGuesses(const Partition *p)
+{
+    return p->Ng;
+}
+
+
+const char *partitionAnswer(const Partition *p, int a)
+{
+    return p->answers[a];
+}
+
+
+const char *partitionGuess(const Partition *p, int g)
+{
+    return p->guesses[g];
+}
+
+
+const unsigned char *partitionAnswerLetters(const Partition *p, int a)
+{
+    return p->answerLetters[a];
+}
+
+
+const unsigned char *partitionGuessLetters(const Partition *p, int g)
+{
+    return p->guessLetters[g];
+}
+
+
+int partitionAlphabetSize(const Partition *p)
+{
+    return alphabetSize(p->alphabet);
+}
+
+
+int partitionFindGuess(const Partition *p, const char *word)
+{
+    if (alphabetWordLength(word) != WORD_LENGTH || !dictContains(p->index, (char *)word))
+        return -1;
+
+    return (int)dictSearch(p->index, (char *)word);
+}
+
+
+int partitionPattern(const Partition *p, int g, int a)
+{
+    if (p->matrix)
+        return p->matrix[(size_t)g * p->Na + a];
+
+    return wordlePatternLetters(p->guessLetters[g], p->answerLetters[a]);
+}
+
+
+uint64_t partitionAnswerKey(const Partition *p, int board, int a)
+{
+    uint64_t z = (uint64_t)board * p->Na + a + 1;
+
+    z *= 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+    return z ^ (z >> 31);
+}
+
+
+uint64_t partitionFingerprint(const Partition *p)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    int Na = partitionNbAnswers(p), Ng = partitionNbGuesses(p);
+
+    for (int w = 0; w < Na + Ng; w++) {
+        const char *word = w < Na ? partitionAnswer(p, w) : partitionGuess(p, w - Na);
+        for (const char *c = word; *c; c++)
+            hash = (hash ^ (unsigned char)*c) * 0x100000001b3ull;
+        hash = (hash ^ '\n') * 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+
+void partitionHistogram(const Partition *p, int g, const int *answers, int n,
+                        int *histogram)
+{
+    memset(histogram, 0, PATTERN_COUNT * sizeof(int));
+
+    if (p->matrix) {
+        const unsigned char *row = p->matrix + (size_t)g * p->Na;
+        for (int i = 0; i < n; i++)
+            histogram[row[answers[i]]]++;
+    }
+    else {
+        for (int i = 0; i < n; i++)
+            histogram[wordlePatternLetters(p->guessLetters[g], p->answerLetters[answers[i]])]++;
+    }
+}
+
+
+void partitionHistogramBatch(const Partition *p, int g, const int *answers,
+                             const int *offsets, int n, int *histograms,
+                             int count)
+{
+    partitionHistogramTiled(p, &g, 1, answers, offsets, n, histograms, count);
+}
+
+
+void partitionHistogramTiled(const Partition *p, const int *guesses, int count,
+                             const int *answers, const int *offsets, int n,
+                             int *histograms, int sets)
+{
+    size_t stride = (size_t)sets * PATTERN_COUNT;
+    int k, i;
+
+    memset(histograms, 0, count * stride * sizeof(int));
+
+    if (p->matrix) {
+        for (k = 0; k < count; k++) {
+            const unsigned char *row = p->matrix + (size_t)guesses[k] * p->Na;
+            int *histogram = histograms + k * stride;
+            for (i = 0; i < n; i++)
+                histogram[offsets[i] + row[answers[i]]]++;
+        }
+        return;
+    }
+
+    // Half of the cache for the answers' words, codes and offsets, the
+    // other half for the histograms being accumulated
+    int tileSize = PARTITION_L2_BYTES / 2 / (WORD_LENGTH + 1 + sizeof(int));
+    unsigned char *tile = memoryAlloc(MEMORY_PARTITION, (size_t)WORD_LENGTH * tileSize);
+    unsigned char *codes = memoryAlloc(MEMORY_PARTITION, tileSize);
+    int *tileOffsets = memoryAlloc(MEMORY_PARTITION, tileSize * sizeof(int));
+    expectNotNull(tile);
+    expectNotNull(codes);
+    expectNotNull(tileOffsets);
+
+    for (int t = 0; t < n; t += tileSize) {
+        int m = n - t < tileSize ? n - t : tileSize;
+
+        // Packing the tile by columns makes the sweeps below sequential,
+        // and lets the kernel compare a letter with many answers at once
+        for (i = 0; i < m; i++) {
+            const unsigned char *answer = p->answerLetters[answers[t + i]];
+            for (int j = 0; j < WORD_LENGTH; j++)
+                tile[(size_t)j * tileSize + i] = answer[j];
+            tileOffsets[i] = offsets[t + i];
+        }
+
+        for (k = 0; k < count; k++) {
+            int *histogram = histograms + k * stride;
+            kernelPatterns(p->guessLetters[guesses[k]], tile, tileSize, m, codes);
+            for (i = 0; i < m; i++)
+                histogram[tileOffsets[i] + codes[i]]++;
+        }
+    }
+
+    memoryFree(tile);
+    memoryFree(codes);
+    memoryFree(tileOffsets);
+}
+
+
+int partitionSplit(const Partition *p, int g, int *answers, int n, int code)
+{
+    int kept = 0;
+
+    if (p->bucket) {
+        const unsigned *row = p->start + (size_t)g * (PATTERN_COUNT + 1);
+        return intersectBucket(p->bucket + row[code], row[code + 1] - row[code],
+                               answers, n);
+    }
+
+    for (int i = 0; i < n; i++)
+        if (partitionPattern(p, g, answers[i]) == code)
+            answers[kept++] = answers[i];
+
+    return kept;
+}
+
+
+/**
+ * @brief Keeps in place the answers of a sorted set that appear in a sorted
+ * bucket. The smaller side drives: a bucket much smaller than the set is
+ * looked up by binary search, otherwise both are merged linearly.
+ */
+static int intersectBucket(const unsigned short *list, int m, int *answers,
+                           int n)
+{
+    int kept = 0;
+    int i = 0, j = 0;
+
+    if ((long)m * 8 < n) {
+        for (j = 0; j < m && i < n; j++) {
+            i = lowerBound(answers, i, n, list[j]);
+            if (i < n && answers[i] == list[j])
+                answers[kept++] = answers[i++];
+        }
+        return kept;
+    }
+
+    while (i < n && j < m) {
+        if (answers[i] < list[j])
+            i++;
+        else if (answers[i] > list[j])
+            j++;
+        else {
+            answers[kept++] = answers[i++];
+            j++;
+        }
+    }
+
+    return kept;
+}
+
+
+/**
+ * @brief Index of the first answer of answers[lo..hi) not smaller than
+ * `value`, found by galloping then binary search.
+ */
+static int lowerBound(const int *answers, int lo, int hi, int value)
+{
+    int step = 1;
+
+    while (lo + step < hi && answers[lo + step] < value) {
+        lo += step;
+        step *= 2;
+    }
+    if (lo + step < hi)
+        hi = lo + step + 1;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (answers[mid] < value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+
+/**
+ * @brief Reads a file of one UTF-8 word per line into an array of words,
+ * and encodes them with the alphabet, which gets their new letters.
+ *
+ * @return the words, or NULL with `error` filled in.
+ */
+static char (*readWords(char *file, Alphabet *alphabet, int *count,
+                        unsigned char (**letters)[WORD_LENGTH],
+                        PartitionError *error))[WORD_BYTES]
+{
+    error->file = file;
+
+    FILE *f = fopen(file, "r");
+    if (f == NULL) {
+        error->status = PARTITION_FILE_ERROR;
+        error->error = errno;
+        return NULL;
+    }
+
+    int capacity = 1024;
+    char (*words)[WORD_BYTES] = memoryAlloc(MEMORY_PARTITION, capacity * sizeof(*words));
+    *letters = memoryAlloc(MEMORY_PARTITION, capacity * sizeof(**letters));
+    expectNotNull(words);
+    expectNotNull(*letters);
+
+    char line[4 * WORD_BYTES];
+    *count = 0;
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0')
+            continue;
+
+        int added = strlen(line) < WORD_BYTES
+                  ? alphabetAdd(alphabet, line, (*letters)[*count]) : 0;
+        if (added <= 0) {
+            error->status = added == 0 ? PARTITION_INVALID_WORD : PARTITION_TOO_MANY_LETTERS;
+            strcpy(error->word, line);
+            break;
+        }
+        strcpy(words[*count], line);
+
+        if (++*count == capacity) {
+            capacity *= 2;
+            words = memoryRealloc(MEMORY_PARTITION, words, capacity * sizeof(*words));
+            *letters = memoryRealloc(MEMORY_PARTITION, *letters, capacity * sizeof(**letters));
+            expectNotNull(words);
+            expectNotNull(*letters);
+        }
+    }
+    if (error->status == PARTITION_OK && ferror(f)) {
+        error->status = PARTITION_FILE_ERROR;
+        error->error = errno;
+    }
+
+    fclose(f);
+
+    if (error->status != PARTITION_OK) {
+        memoryFree(words);
+        memoryFree(*letters);
+        return NULL;
+    }
+
+    return words;
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,338 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "wordle.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Represents the word tables shared by the game and the solver: the
+ * possible answers, the accepted guesses and the patterns they produce.
+ */
+typedef struct Partition_t Partition;
+
+#ifndef PARTITION_TABLES_MAX_BYTES
+#define PARTITION_TABLES_MAX_BYTES ((size_t)512 << 20) // Budget of the matrix and index
+#endif
+#define PARTITION_L2_BYTES (256 * 1024) // Cache size targeted by tiled scoring
+
+/**
+ * @brief Reasons why word files could not be loaded.
+ */
+typedef enum
+{
+    PARTITION_OK,
+    PARTITION_FILE_ERROR,     // A file could not be opened or read
+    PARTITION_INVALID_WORD,   // A word is not made of WORD_LENGTH letters
+    PARTITION_TOO_MANY_LETTERS // More than ALPHABET_MAX_LETTERS letters
+} PartitionStatus;
+
+/**
+ * @brief Error met while loading word files.
+ */
+typedef struct PartitionError_t
+{
+    PartitionStatus status;
+    const char *file;            // File of the error
+    char word[4 * WORD_BYTES];   // The invalid word (PARTITION_INVALID_WORD)
+    int error;                   // errno (PARTITION_FILE_ERROR)
+} PartitionError;
+
+/**
+ * @brief Loads the word files into a new partition engine. Words are read
+ * as UTF-8, one per line, and the letters of both files are mapped to the
+ * indices of a shared alphabet of at most ALPHABET_MAX_LETTERS letters.
+ * Exits with a message if the files cannot be loaded.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ *
+ * @return The created engine.
+ */
+Partition *partitionCreate(char *answers_file, char *guesses_file);
+
+/**
+ * @brief Loads the word files into a new partition engine, as
+ * partitionCreate, but reports the errors instead of exiting.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param error Filled with the error, if any.
+ *
+ * @return The created engine, or NULL if the files cannot be loaded.
+ */
+Partition *partitionLoad(char *answers_file, char *guesses_file,
+                         PartitionError *error);
+
+/**
+ * @brief Prints the message of an error met while loading word files.
+ *
+ * @param error The error.
+ * @param out File to print to.
+ */
+void partitionReportError(const PartitionError *error, FILE *out);
+
+/**
+ * @brief Words added and removed by a reload of the word files.
+ */
+typedef struct PartitionChanges_t
+{
+    int addedAnswers;
+    int removedAnswers;
+    int addedGuesses;
+    int removedGuesses;
+} PartitionChanges;
+
+/**
+ * @brief Loads new versions of the word files into a new engine, reusing
+ * the tables of an engine built from the old ones. If the old engine has
+ * its pattern matrix, the new one has it too: the patterns of a word kept
+ * are copied, so only the rows of the added guesses and the columns of
+ * the added answers are computed. The inverted index is then rebuilt from
+ * the matrix, without computing any pattern.
+ *
+ * The old engine is not modified, and its owners may keep using it.
+ *
+ * @param p Engine of the old word files.
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ * @param changes Filled with the number of words added and removed.
+ * @param error Filled with the error, if any.
+ *
+ * @return The created engine, or NULL if the new files cannot be loaded.
+ */
+Partition *partitionReload(const Partition *p, char *answers_file,
+                           char *guesses_file, PartitionChanges *changes,
+                           PartitionError *error);
+
+/**
+ * @brief Adds an owner to a partition engine. Each owner releases it with
+ * partitionFree, the last one actually frees it.
+ *
+ * @param p The engine.
+ *
+ * @return the engine.
+ */
+Partition *partitionShare(Partition *p);
+
+/**
+ * @brief Releases a partition engine, freeing it if it has no other owner.
+ *
+ * @param p Engine to free.
+ */
+void partitionFree(Partition *p);
+
+/**
+ * @brief Precomputes the pattern of every (guess, answer) pair, so that
+ * later histograms read a table instead of comparing words. Nothing is
+ * built if the matrix would exceed PARTITION_TABLES_MAX_BYTES.
+ *
+ * @param p The engine.
+ *
+ * @return 1 if the matrix is available, 0 otherwise.
+ */
+int partitionBuildMatrix(Partition *p);
+
+/**
+ * @brief Builds, with the pattern matrix, the inverted index giving for
+ * every guess and pattern code the sorted list of answers producing it.
+ * partitionSplit then intersects sets with these lists instead of
+ * rescanning them. Nothing is built for more than 65536 answers or when
+ * the matrix and index would exceed PARTITION_TABLES_MAX_BYTES.
+ *
+ * @param p The engine.
+ */
+void partitionBuildIndex(Partition *p);
+
+/**
+ * @brief Moves the pattern matrix and the inverted index of an engine to a
+ * read-only mapping shared with the processes forked afterwards, so that
+ * any number of them read the same physical pages. Does nothing if the
+ * engine has no matrix. The tables cannot be built or rebuilt afterwards.
+ *
+ * @param p The engine.
+ */
+void partitionMapShared(Partition *p);
+
+/**
+ * @brief Get the number of possible answers.
+ *
+ * @param p The engine.
+ *
+ * @return the number of possible answers.
+ */
+int partitionNbAnswers(const Partition *p);
+
+/**
+ * @brief Get the number of accepted guesses.
+ *
+ * @param p The engine.
+ *
+ * @return the number of accepted guesses.
+ */
+int partitionNbGuesses(const Partition *p);
+
+/**
+ * @brief Get a possible answer.
+ *
+ * @param p The engine.
+ * @param a Index of the answer.
+ *
+ * @return the answer (WORD_LENGTH UTF-8 letters + '\0').
+ */
+const char *partitionAnswer(const Partition *p, int a);
+
+/**
+ * @brief Get an accepted guess.
+ *
+ * @param p The engine.
+ * @param g Index of the guess.
+ *
+ * @return the guess (WORD_LENGTH UTF-8 letters + '\0').
+ */
+const char *partitionGuess(const Partition *p, int g);
+
+/**
+ * @brief Get a possible answer as letter indices of the engine's alphabet,
+ * which both word lists share (see alphabet.h).
+ *
+ * @param p The engine.
+ * @param a Index of the answer.
+ *
+ * @return the WORD_LENGTH letter indices of the answer.
+ */
+const unsigned char *partitionAnswerLetters(const Partition *p, int a);
+
+/**
+ * @brief Get an accepted guess as letter indices of the engine's alphabet.
+ *
+ * @param p The engine.
+ * @param g Index of the guess.
+ *
+ * @return the WORD_LENGTH letter indices of the guess.
+ */
+const unsigned char *partitionGuessLetters(const Partition *p, int g);
+
+/**
+ * @brief Get the number of distinct letters of the word lists.
+ *
+ * @param p The engine.
+ *
+ * @return the size of the alphabet, at most ALPHABET_MAX_LETTERS.
+ */
+int partitionAlphabetSize(const Partition *p);
+
+/**
+ * @brief Search for a word in the accepted guesses.
+ *
+ * @param p The engine.
+ * @param word Word to search for.
+ *
+ * @return the index of the guess, or -1 if the word is not accepted.
+ */
+int partitionFindGuess(const Partition *p, const char *word);
+
+/**
+ * @brief Get the pattern code of a guess against an answer.
+ *
+ * @param p The engine.
+ * @param g Index of the guess.
+ * @param a Index of the answer.
+ *
+ * @return the pattern code.
+ */
+int partitionPattern(const Partition *p, int g, int a);
+
+/**
+ * @brief Get the Zobrist key of an answer on a board: the hash of a set of
+ * answers is the exclusive or of their keys, and can be updated answer by
+ * answer. Keys are derived by SplitMix64 rather than drawn and stored.
+ *
+ * @param p The engine.
+ * @param board Index of the board.
+ * @param a Index of the answer.
+ *
+ * @return the key.
+ */
+uint64_t partitionAnswerKey(const Partition *p, int board, int a);
+
+/**
+ * @brief Get a fingerprint of the word lists: the FNV-1a hash of the
+ * answers and the guesses, in order. Files computed for other lists can be
+ * told apart by it.
+ *
+ * @param p The engine.
+ *
+ * @return the fingerprint.
+ */
+uint64_t partitionFingerprint(const Partition *p);
+
+/**
+ * @brief Counts how many answers of a set fall in each pattern bucket of
+ * a guess.
+ *
+ * @param p The engine.
+ * @param g Index of the guess.
+ * @param answers Indices of the answers.
+ * @param n Number of answers.
+ * @param histogram Array of PATTERN_COUNT counters, overwritten.
+ */
+void partitionHistogram(const Partition *p, int g, const int *answers, int n,
+                        int *histogram);
+
+/**
+ * @brief Counts the pattern buckets of a guess for several answer sets at
+ * once, in a single sweep over their merged answers. The i-th answer is
+ * counted in the histogram starting at histograms[offsets[i]].
+ *
+ * @param p The engine.
+ * @param g Index of the guess.
+ * @param answers Indices of the answers of all sets.
+ * @param offsets Offset of the histogram of the set of each answer.
+ * @param n Number of answers.
+ * @param histograms Array of count x PATTERN_COUNT counters, overwritten.
+ * @param count Number of histograms.
+ */
+void partitionHistogramBatch(const Partition *p, int g, const int *answers,
+                             const int *offsets, int n, int *histograms,
+                             int count);
+
+/**
+ * @brief Counts the pattern buckets of several guesses for several answer
+ * sets, like partitionHistogramBatch for each guess. Without the pattern
+ * matrix, patterns are computed on the fly by tiles of answers sized for
+ * PARTITION_L2_BYTES, each tile being swept by every guess while the
+ * guesses' histograms stay in cache. The working memory does not depend on
+ * the size of the dictionaries.
+ *
+ * @param p The engine.
+ * @param guesses Indices of the guesses.
+ * @param count Number of guesses.
+ * @param answers Indices of the answers of all sets.
+ * @param offsets Offset of the histogram of the set of each answer.
+ * @param n Number of answers.
+ * @param histograms Array of count x sets x PATTERN_COUNT counters,
+ * overwritten. The histograms of the k-th guess start at
+ * histograms[k * sets * PATTERN_COUNT].
+ * @param sets Number of histograms per guess.
+ */
+void partitionHistogramTiled(const Partition *p, const int *guesses, int count,
+                             const int *answers, const int *offsets, int n,
+                             int *histograms, int sets);
+
+/**
+ * @brief Keeps in place, in their original order, the answers of a set
+ * that produce a given pattern with a guess. Once the index is built, the
+ * set must be sorted in increasing order.
+ *
+ * @param p The engine.
+ * @param g Index of the guess.
+ * @param answers Indices of the answers.
+ * @param n Number of answers.
+ * @param code Pattern code to keep.
+ *
+ * @return the number of answers kept.
+ */
+int partitionSplit(const Partition *p, int g, int *answers, int n, int code);
+
+#endif
@@ -0,0 +1,291 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "scheduler.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+
+typedef struct
+{
+    SchedulerTask task;
+    void *arg;
+} Job;
+
+/**
+ * @brief Deque of jobs in a ring buffer: the owner pushes and pops at the
+ * bottom, thieves take from the top.
+ */
+typedef struct
+{
+    pthread_mutex_t lock;
+    Job *jobs;
+    long capacity;
+    long top;    // Index of the oldest job
+    long bottom; // Index after the newest job
+} Deque;
+
+typedef struct
+{
+    Scheduler *scheduler;
+    int id;
+    Deque deque;
+    pthread_t thread;
+    unsigned seed; // Choice of the victims to steal from
+} Worker;
+
+struct Scheduler_t
+{
+    int threads;
+    Worker *workers;
+
+    long pending;  // Tasks spawned and not finished yet
+    long queued;   // Tasks waiting in a deque
+    int sleepers;  // Workers waiting for a task to be spawned
+    int stop;      // Set to 1 when the workers must return
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake; // A task was spawned, or the workers must stop
+    pthread_cond_t done; // No task is pending anymore
+};
+
+
+// Worker run by the current thread, NULL outside of the scheduler's threads
+static __thread Worker *currentWorker = NULL;
+
+static void *workerLoop(void *arg);
+static int takeJob(Worker *worker, Job *job);
+static void pushBottom(Deque *deque, Job job);
+static int popBottom(Deque *deque, Job *job);
+static int popTop(Deque *deque, Job *job);
+static void expectNotNull(void *p);
+
+
+Scheduler *schedulerCreate(int threads)
+{
+    Scheduler *scheduler = memoryAlloc(MEMORY_SCHEDULER, sizeof(Scheduler));
+    expectNotNull(scheduler);
+
+    scheduler->threads = threads < 1 ? 1 : threads;
+    scheduler->pending = 0;
+    scheduler->queued = 0;
+    scheduler->sleepers = 0;
+    scheduler->stop = 0;
+    pthread_mutex_init(&scheduler->lock, NULL);
+    pthread_cond_init(&scheduler->wake, NULL);
+    pthread_cond_init(&scheduler->done, NULL);
+
+    scheduler->workers = memoryAlloc(MEMORY_SCHEDULER, scheduler->threads * sizeof(Worker));
+    expectNotNull(scheduler->workers);
+
+    for (int w = 0; w < scheduler->threads; w++) {
+        Worker *worker = &scheduler->workers[w];
+        worker->scheduler = scheduler;
+        worker->id = w;
+        worker->seed = 2654435761u * (w + 1);
+        pthread_mutex_init(&worker->deque.lock, NULL);
+        worker->deque.capacity = 64;
+        worker->deque.jobs = memoryAlloc(MEMORY_SCHEDULER, worker->deque.capacity * sizeof(Job));
+        expectNotNull(worker->deque.jobs);
+        worker->deque.top = worker->deque.bottom = 0;
+    }
+
+    for (int w = 0; w < scheduler->threads; w++) {
+        if (pthread_create(&scheduler->workers[w].thread, NULL, workerLoop,
+                           &scheduler->workers[w]) != 0) {
+            perror("Une erreur est survenue :");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return scheduler;
+}
+
+
+void schedulerFree(Scheduler *scheduler)
+{
+    pthread_mutex_lock(&scheduler->lock);
+    scheduler->stop = 1;
+    pthread_cond_broadcast(&scheduler->wake);
+    pthread_mutex_unlock(&scheduler->lock);
+
+    for (int w = 0; w < scheduler->threads; w++) {
+        pthread_join(scheduler->workers[w].thread, NULL);
+        pthread_mutex_destroy(&scheduler->workers[w].deque.lock);
+        memoryFree(scheduler->workers[w].deque.jobs);
+    }
+
+    pthread_mutex_destroy(&scheduler->lock);
+    pthread_cond_destroy(&scheduler->wake);
+    pthread_cond_destroy(&scheduler->done);
+    memoryFree(scheduler->workers);
+    memoryFree(scheduler);
+}
+
+
+int schedulerNbThreads(Scheduler *scheduler)
+{
+    return scheduler->threads;
+}
+
+
+void schedulerSpawn(Scheduler *scheduler, SchedulerTask task, void *arg)
+{
+    Worker *worker = currentWorker;
+    if (worker == NULL || worker->scheduler != scheduler)
+        worker = &scheduler->workers[0];
+
+    Job job = {task, arg};
+
+    __atomic_add_fetch(&scheduler->pending, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&scheduler->queued, 1, __ATOMIC_SEQ_CST);
+    pushBottom(&worker->deque, job);
+
+    // A sleeper registers before checking `queued`, so it sees this job or
+    // gets signaled
+    if (__atomic_load_n(&scheduler->sleepers, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&scheduler->lock);
+        pthread_cond_signal(&scheduler->wake);
+        pthread_mutex_unlock(&scheduler->lock);
+    }
+}
+
+
+void schedulerWait(Scheduler *scheduler)
+{
+    pthread_mutex_lock(&scheduler->lock);
+    while (__atomic_load_n(&scheduler->pending, __ATOMIC_SEQ_CST) > 0)
+        pthread_cond_wait(&scheduler->done, &scheduler->lock);
+    pthread_mutex_unlock(&scheduler->lock);
+}
+
+
+static void *workerLoop(void *arg)
+{
+    Worker *worker = arg;
+    Scheduler *scheduler = worker->scheduler;
+    Job job;
+
+    currentWorker = worker;
+
+    while (1) {
+        if (takeJob(worker, &job)) {
+            job.task(scheduler, job.arg);
+
+            if (__atomic_sub_fetch(&scheduler->pending, 1, __ATOMIC_SEQ_CST) == 0) {
+                pthread_mutex_lock(&scheduler->lock);
+                pthread_cond_broadcast(&scheduler->done);
+                pthread_mutex_unlock(&scheduler->lock);
+            }
+            continue;
+        }
+
+        pthread_mutex_lock(&scheduler->lock);
+        __atomic_add_fetch(&scheduler->sleepers, 1, __ATOMIC_SEQ_CST);
+        while (!scheduler->stop
+               && __atomic_load_n(&scheduler->queued, __ATOMIC_SEQ_CST) == 0)
+            pthread_cond_wait(&scheduler->wake, &scheduler->lock);
+        __atomic_sub_fetch(&scheduler->sleepers, 1, __ATOMIC_SEQ_CST);
+        int stop = scheduler->stop;
+        pthread_mutex_unlock(&scheduler->lock);
+
+        if (stop)
+            return NULL;
+    }
+}
+
+
+/**
+ * @brief Takes the newest job of the worker's deque, or else steals the
+ * oldest job of another worker, starting from a random victim.
+ */
+static int takeJob(Worker *worker, Job *job)
+{
+    Scheduler *scheduler = worker->scheduler;
+
+    if (popBottom(&worker->deque, job)) {
+        __atomic_sub_fetch(&scheduler->queued, 1, __ATOMIC_SEQ_CST);
+        return 1;
+    }
+
+    worker->seed = worker->seed * 1103515245u + 12345u;
+    int first = (worker->seed >> 16) % scheduler->threads;
+
+    for (int k = 0; k < scheduler->threads; k++) {
+        Worker *victim = &scheduler->workers[(first + k) % scheduler->threads];
+        if (victim != worker && popTop(&victim->deque, job)) {
+            __atomic_sub_fetch(&scheduler->queued, 1, __ATOMIC_SEQ_CST);
+            return 1;
+        }
+    }
+
+    // Jobs may still be queued by a worker which has not finished pushing
+    if (__atomic_load_n(&scheduler->queued, __ATOMIC_SEQ_CST) > 0)
+        sched_yield();
+
+    return 0;
+}
+
+
+static void pushBottom(Deque *deque, Job job)
+{
+    pthread_mutex_lock(&deque->lock);
+
+    if (deque->bottom - deque->top == deque->capacity) {
+        Job *jobs = memoryAlloc(MEMORY_SCHEDULER, 2 * deque->capacity * sizeof(Job));
+        expectNotNull(jobs);
+        for (long i = deque->top; i < deque->bottom; i++)
+            jobs[i % (2 * deque->capacity)] = deque->jobs[i % deque->capacity];
+        memoryFree(deque->jobs);
+        deque->jobs = jobs;
+        deque->capacity *= 2;
+    }
+
+    deque->jobs[deque->bottom % deque->capacity] = job;
+    deque->bottom++;
+
+    pthread_mutex_unlock(&deque->lock);
+}
+
+
+static int popBottom(Deque *deque, Job *job)
+{
+    int found = 0;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top) {
+        deque->bottom--;
+        *job = deque->jobs[deque->bottom % deque->capacity];
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return found;
+}
+
+
+static int popTop(Deque *deque, Job *job)
+{
+    int found = 0;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top) {
+        *job = deque->jobs[deque->top % deque->capacity];
+        deque->top++;
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return found;
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
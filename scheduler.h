@@ -0,0 +1,63 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/**
+ * @brief Represents a pool of worker threads sharing tasks by work stealing:
+ * each worker runs the tasks of its own deque last-in first-out, and an idle
+ * worker steals the oldest task of another worker.
+ */
+typedef struct Scheduler_t Scheduler;
+
+/**
+ * @brief Function run by a task.
+ *
+ * @param scheduler The scheduler running the task, to spawn subtasks.
+ * @param arg Argument given when the task was spawned.
+ */
+typedef void (*SchedulerTask)(Scheduler *scheduler, void *arg);
+
+/**
+ * @brief Creates a scheduler and starts its workers.
+ *
+ * @param threads Number of worker threads (at least 1).
+ *
+ * @return The created scheduler.
+ */
+Scheduler *schedulerCreate(int threads);
+
+/**
+ * @brief Stops the workers and frees a scheduler. Tasks not run yet are
+ * dropped.
+ *
+ * @param scheduler Scheduler to free.
+ */
+void schedulerFree(Scheduler *scheduler);
+
+/**
+ * @brief Get the number of worker threads.
+ *
+ * @param scheduler The scheduler.
+ *
+ * @return the number of workers.
+ */
+int schedulerNbThreads(Scheduler *scheduler);
+
+/**
+ * @brief Adds a task. From a task, it goes to the deque of the worker
+ * running it; from another thread, to the deque of the first worker.
+ *
+ * @param scheduler The scheduler.
+ * @param task Function to run.
+ * @param arg Argument to pass to the function.
+ */
+void schedulerSpawn(Scheduler *scheduler, SchedulerTask task, void *arg);
+
+/**
+ * @brief Waits until every task spawned so far, and every task they
+ * spawned, has been run. Must not be called from a task.
+ *
+ * @param scheduler The scheduler.
+ */
+void schedulerWait(Scheduler *scheduler);
+
+#endif
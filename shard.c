@@ -0,0 +1,107 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "shard.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+
+static void expectNotNull(void *p);
+
+
+FILE **shardRun(int shards, ShardWork work, void *context)
+{
+    FILE **files = memoryAlloc(MEMORY_SHARD, shards * sizeof(FILE *));
+    pid_t *pids = memoryAlloc(MEMORY_SHARD, shards * sizeof(pid_t));
+    expectNotNull(files);
+    expectNotNull(pids);
+
+    // Otherwise what is buffered would be written once more by each shard
+    fflush(stdout);
+    fflush(stderr);
+
+    for (int s = 0; s < shards; s++) {
+        files[s] = tmpfile();
+        expectNotNull(files[s]);
+
+        pids[s] = fork();
+        if (pids[s] < 0) {
+            perror("Une erreur est survenue :");
+            exit(EXIT_FAILURE);
+        }
+
+        if (pids[s] == 0) {
+            work(s, files[s], context);
+            fflush(files[s]);
+            fflush(stdout);
+            _exit(ferror(files[s]) ? EXIT_FAILURE : EXIT_SUCCESS);
+        }
+    }
+
+    int failed = 0;
+    for (int s = 0; s < shards; s++) {
+        int status;
+        if (waitpid(pids[s], &status, 0) < 0 || !WIFEXITED(status)
+            || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            fprintf(stderr, "Le shard %d s'est arrêté anormalement.\n", s);
+            failed = 1;
+        }
+        rewind(files[s]);
+    }
+
+    if (failed)
+        exit(EXIT_FAILURE);
+
+    memoryFree(pids);
+
+    return files;
+}
+
+
+void shardDeal(const int *sizes, int count, int shards, int *owner)
+{
+    int *order = memoryAlloc(MEMORY_SHARD, count * sizeof(int));
+    long *load = memoryCalloc(MEMORY_SHARD, shards, sizeof(long));
+    expectNotNull(order);
+    expectNotNull(load);
+
+    // Insertion sort, by decreasing size: there are a few hundred items
+    for (int i = 0; i < count; i++) {
+        int j = i;
+        for (; j > 0 && sizes[order[j - 1]] < sizes[i]; j--)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int lightest = 0;
+        for (int s = 1; s < shards; s++)
+            if (load[s] < load[lightest])
+                lightest = s;
+        owner[order[i]] = lightest;
+        load[lightest] += sizes[order[i]];
+    }
+
+    memoryFree(order);
+    memoryFree(load);
+}
+
+
+void shardClose(FILE **files, int shards)
+{
+    for (int s = 0; s < shards; s++)
+        fclose(files[s]);
+    memoryFree(files);
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <stdio.h>
+
+/**
+ * @brief Work of one shard, run in its own process.
+ *
+ * @param shard Index of the shard, in [0, shards).
+ * @param out Result file of the shard, read back by the parent.
+ * @param context Context given to shardRun.
+ */
+typedef void (*ShardWork)(int shard, FILE *out, void *context);
+
+/**
+ * @brief Runs a job split into shards, each in a process forked from the
+ * caller: the shards start with the caller's memory (shared mappings
+ * included, see memoryMapShared) and report through their result file
+ * only, so that a shard crashing leaves the others and the caller
+ * untouched. The caller must not have threads running.
+ *
+ * @param shards Number of shards.
+ * @param work Work of each shard.
+ * @param context Context passed to the work.
+ *
+ * @return The result file of each shard, rewound. Exits if a shard did not
+ * end normally.
+ */
+FILE **shardRun(int shards, ShardWork work, void *context);
+
+/**
+ * @brief Deals items to shards so that their total sizes are close: the
+ * largest items first, each to the shard with the smallest total so far.
+ *
+ * @param sizes Size of each item.
+ * @param count Number of items.
+ * @param shards Number of shards.
+ * @param owner Filled with the shard of each item.
+ */
+void shardDeal(const int *sizes, int count, int shards, int *owner);
+
+/**
+ * @brief Closes the result files returned by shardRun.
+ *
+ * @param files The files.
+ * @param shards Number of shards.
+ */
+void shardClose(FILE **files, int shards);
+
+#endif
@@ -1,7 +1,12 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "solver.h"
 #include "wordle.h"
-#include "dict.h"
-#include "LinkedList.h"
+#include "partition.h"
+#include "memory.h"
+#include "transposition.h"
+#include "minimax.h"
+#include "alphabet.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -9,197 +14,1369 @@
 #include <error.h>
 #include <errno.h>
 #include <assert.h>
+#include <time.h>
+#include <stdint.h>
 
 
-#define PATTERN_COUNT 125 // The number of possible patterns of length 5 that can be made with the 3 symbols: '_', '*' and 'o'
+/**
+ * @brief State of the solver after some number of updates. Its possible
+ * answers follow those of the previous frame in the arenas.
+ */
+typedef struct
+{
+    size_t start; // Position of the possible answers in the arenas
+    int Na;       // Number of possible answers
+    int removed;  // Position in Sg of the guess removed by the update, or -1
+    uint64_t hash; // Zobrist hash of the possible answers of every board
+} Frame;
 
+/**
+ * @brief Frozen state of a solver, read by its clones and never written.
+ * Freed with its last owner.
+ */
+typedef struct
+{
+    int owners; // Number of releaseShared expected
+    int *Sa;    // Possible answers, as in the solver it was frozen from
+    int *base;
+    int Na;
+    int *Sg;    // Valid guesses
+    int Ng;
+} SharedState;
 
 struct Solver_t {
-    List *Sa; // Possible answers
-    List *Sg; // Valid guesses
-    int Ng;   // Number of possible guesses
-    int Na;   // Number of possible answers
+    Partition *engine; // Word tables and patterns
+    int *Sa;           // Possible answers of all unsolved boards, merged
+    int *base;         // Histogram offset of the board of each answer of Sa
+    int *Sg;           // Valid guesses (indices of engine guesses)
+    int Na;            // Number of possible answers, over all boards
+    int Ng;            // Number of possible guesses
+
+    int boards;       // Number of simultaneous boards
+    int *Nb;          // Number of possible answers of each board
+    int *solved;      // 1 for the boards whose answer has been found
+    int tile;         // Number of guesses scored per pass
+    int *histograms;  // tile x boards x PATTERN_COUNT counters for scoring
+
+    // Histograms of every engine guess kept between moves, or NULL, and
+    // the answers (with their offsets) they were counted for
+    int incremental;  // 1 to keep them
+    int *kept;        // Ng (of the engine) x boards x PATTERN_COUNT counters
+    int *keptSa;
+    int *keptBase;
+    int keptNa;
+    int synced;       // 1 while `kept` counts the current answers
+
+    // Undo stack: Sa, base, Nb and solved point into the current frame
+    int *arena;       // Possible answers of every frame
+    int *arenaBase;   // Histogram offsets of the answers of `arena`
+    size_t arenaSize; // Capacity of the arenas
+    Frame *frames;    // frames[d]: state after d updates not undone
+    int *boardStates; // Nb then solved of every frame (2 x boards each)
+    int depth;        // Current frame
+    int maxDepth;     // Capacity of `frames` and `boardStates`
+
+    // Copy on write: a clone reads its first frame and its guesses from the
+    // state it was cloned from until it writes them
+    SharedState *shared; // First frame of a clone, or NULL
+    SharedState *frozen; // Current state, frozen for clones, or NULL
+    int ownsSg;          // 0 while Sg is the one of `shared`
+
+    Transposition *table; // Decisions shared between states, or NULL
+    SolverStrategy strategy;
+    Metric metric;        // Criterion of SOLVER_AVERAGE searches
+    MetricScore score;    // Function of `metric`
+    int approximate;      // 1 to only score the best ranked guesses
+    int sampleSize;       // Answers sampled by a search, or 0
+    uint64_t seed;        // Seed of the samples
+    SolverSample sample;  // Sampling of the last search
+
+    // State of the anytime search, reset by solverUpdate
+    int *order;       // Guesses of Sg sorted by decreasing priority
+    int scanned;      // Number of guesses of `order` already scored
+    int best;         // Best guess found so far, or -1
+    double bestScore; // Score of `best`
 };
 
+/**
+ * @brief Scored guess kept by a ranking. `rank` is its position in the
+ * scoring order, which breaks ties as the anytime search does.
+ */
+typedef struct
+{
+    double score;
+    int rank;
+    int guess;
+} RankedScore;
+
+/**
+ * @brief Bounded min-heap of the best guesses met while scoring: the worst
+ * of them is on top, and is replaced when a better guess is met.
+ */
+typedef struct
+{
+    RankedScore *heap;
+    int size;
+    int capacity;
+} Ranking;
+
+/**
+ * @brief Guess paired with its priority, used to sort Sg.
+ */
+typedef struct
+{
+    int guess;
+    long priority;
+} RankedGuess;
+
 
+static Solver *startEngine(Partition *engine, int boards);
 static void expectNotNull(void *p);
+static void allocateFrames(Solver *solver, size_t arenaSize, int maxDepth);
+static void reserveFrame(Solver *solver);
+static void selectFrame(Solver *solver);
+static size_t frameEnd(Solver *solver);
+static SharedState *freeze(Solver *solver);
+static void releaseShared(SharedState *state);
+static int splitByWord(Solver *solver, const char *guess, int *answers,
+                       int n, int code);
+static double scoreHistograms(Solver *solver, const int *histograms);
+static double sampledSearch(Solver *solver);
+static uint64_t nextRandom(uint64_t *state);
+static void syncHistograms(Solver *solver);
+static int changedAnswers(const int *fromSa, const int *fromBase, int m,
+                          const int *toSa, const int *toBase, int n,
+                          int *changedSa, int *changedBase);
+static void scoreTile(Solver *solver, const int *guesses, int count,
+                      int *histograms, double *bestScore, int *best,
+                      Ranking *ranking);
+static void rankingPush(Ranking *ranking, double score, int rank, int guess);
+static int isWorse(const RankedScore *a, const RankedScore *b);
+static int compareScores(const void *a, const void *b);
+static void resetSearch(Solver *solver);
+static int searchSize(Solver *solver);
+static uint64_t searchKey(Solver *solver);
+static void orderGuesses(Solver *solver);
+static void selectRanked(RankedGuess *ranked, int count, int k);
+static int compareRanked(const void *a, const void *b);
+static int compareInts(const void *a, const void *b);
+static double elapsedMs(const struct timespec *start);
 
 
 Solver *solverStart(char *answers_file, char *guesses_file)
 {
-    Solver *solver = malloc(sizeof(Solver));
+    return solverStartBoards(answers_file, guesses_file, 1);
+}
+
+
+Solver *solverStartBoards(char *answers_file, char *guesses_file, int boards)
+{
+    return startEngine(partitionCreate(answers_file, guesses_file), boards);
+}
+
+
+Solver *solverStartEngine(Partition *engine)
+{
+    return startEngine(engine, 1);
+}
+
+
+/**
+ * @brief Creates a solver on an engine, taking over one of its owners.
+ */
+static Solver *startEngine(Partition *engine, int boards)
+{
+    assert(0 < boards);
+
+    Solver *solver = memoryAlloc(MEMORY_SOLVER, sizeof(Solver));
     expectNotNull(solver);
 
-    solver->Sa = llCreateEmpty();
-    expectNotNull(solver->Sa);
+    solver->engine = engine;
+    partitionBuildIndex(solver->engine);
+
+    int answers = partitionNbAnswers(solver->engine);
+
+    solver->boards = boards;
+
+    // Without the pattern matrix, guesses are scored by tiles whose
+    // histograms stay in cache while answers are streamed
+    solver->tile = PARTITION_L2_BYTES / 2 / (boards * PATTERN_COUNT * sizeof(int));
+    if (solver->tile > 64)
+        solver->tile = 64;
+    if (solver->tile < 1)
+        solver->tile = 1;
+    solver->histograms = NULL;
+    solver->incremental = 0;
+    solver->kept = NULL;
+    solver->keptSa = NULL;
+    solver->keptBase = NULL;
+    solver->keptNa = 0;
+
+    solver->shared = NULL;
+    solver->frozen = NULL;
+    solver->table = NULL;
+    solver->strategy = SOLVER_AVERAGE;
+    solver->metric = METRIC_EXPECTED;
+    solver->score = metricFunction(METRIC_EXPECTED);
+    solver->approximate = 0;
+    solver->sampleSize = 0;
+    solver->seed = 0;
+    solver->sample.size = 0;
+
+    // Boards are stored one after the other in the merged array
+    allocateFrames(solver, 2 * (size_t)boards * answers, 8);
+    solver->frames[0].start = 0;
+    solver->frames[0].Na = boards * answers;
+    solver->frames[0].removed = -1;
+    solver->frames[0].hash = 0;
+    selectFrame(solver);
+
+    for (int b = 0; b < boards; b++) {
+        solver->Nb[b] = answers;
+        solver->solved[b] = 0;
+        for (int a = 0; a < answers; a++) {
+            solver->Sa[b * answers + a] = a;
+            solver->base[b * answers + a] = b * PATTERN_COUNT;
+            solver->frames[0].hash ^= partitionAnswerKey(solver->engine, b, a);
+        }
+    }
 
-    solver->Sg = llCreateEmpty();
+    solver->Ng = partitionNbGuesses(solver->engine);
+    solver->Sg = memoryAlloc(MEMORY_SOLVER, solver->Ng * sizeof(int));
     expectNotNull(solver->Sg);
+    for (int g = 0; g < solver->Ng; g++)
+        solver->Sg[g] = g;
+    solver->ownsSg = 1;
 
-    char *word = calloc(WORD_LENGTH + 1, sizeof(char));
-    expectNotNull(word);
+    solver->order = NULL;
+    resetSearch(solver);
 
-    char *cpy = NULL;
+    return solver;
+}
 
-    Node *n = NULL;
 
-    FILE *f_answers = fopen(answers_file, "r");
-    expectNotNull(f_answers);
+void solverFree(Solver *solver)
+{
+    resetSearch(solver);
+    partitionFree(solver->engine);
+    memoryFree(solver->arena);
+    memoryFree(solver->arenaBase);
+    memoryFree(solver->frames);
+    memoryFree(solver->boardStates);
+    memoryFree(solver->histograms);
+    memoryFree(solver->kept);
+    memoryFree(solver->keptSa);
+    memoryFree(solver->keptBase);
+    if (solver->ownsSg)
+        memoryFree(solver->Sg);
+    if (solver->shared)
+        releaseShared(solver->shared);
+    if (solver->frozen)
+        releaseShared(solver->frozen);
+    memoryFree(solver);
+}
 
-    solver->Na = 0;
-    while(fgets(word, WORD_LENGTH + 1, f_answers)) {
-        cpy = calloc(WORD_LENGTH + 1, sizeof(char));
-        expectNotNull(cpy);
 
-        strcpy(cpy, word);
+Solver *solverClone(Solver *solver)
+{
+    SharedState *state = freeze(solver);
 
-        n = llCreateNode(cpy);
-        expectNotNull(n);
+    Solver *clone = memoryAlloc(MEMORY_SOLVER, sizeof(Solver));
+    expectNotNull(clone);
 
-        llInsertLast(solver->Sa, n);
-        solver->Na++;
-        fgetc(f_answers); // chomp \n character to get to new line
-    }
-    if (ferror(f_answers)) {
-        fprintf(stderr, "Une erreur est survenue lors de la lecture du ficher %s: %s", answers_file, strerror(errno));
-        exit(EXIT_FAILURE);
-    }
+    *clone = *solver;
+    clone->engine = partitionShare(solver->engine);
 
-    FILE *f_guesses = fopen(guesses_file, "r");
-    expectNotNull(f_guesses);
+    __atomic_add_fetch(&state->owners, 1, __ATOMIC_SEQ_CST);
+    clone->shared = state;
+    clone->frozen = NULL;
+    clone->Sg = state->Sg;
+    clone->Ng = state->Ng;
+    clone->ownsSg = 0;
 
-    solver->Ng = 0;
-    while(fgets(word, WORD_LENGTH + 1, f_guesses)) {
-        cpy = calloc(WORD_LENGTH + 1, sizeof(char));
-        expectNotNull(cpy);
+    // The frozen state is the first frame, the arenas only grow on update
+    clone->arena = NULL;
+    clone->arenaBase = NULL;
+    clone->arenaSize = 0;
+    clone->histograms = NULL;
+    clone->incremental = 0;
+    clone->kept = NULL;
+    clone->keptSa = NULL;
+    clone->keptBase = NULL;
+    clone->keptNa = 0;
+    clone->maxDepth = 8;
+    clone->frames = memoryAlloc(MEMORY_SOLVER, clone->maxDepth * sizeof(Frame));
+    clone->boardStates = memoryAlloc(MEMORY_SOLVER, (size_t)clone->maxDepth * 2 * solver->boards * sizeof(int));
+    expectNotNull(clone->frames);
+    expectNotNull(clone->boardStates);
 
-        strcpy(cpy, word);
+    clone->depth = 0;
+    clone->frames[0].start = 0;
+    clone->frames[0].Na = state->Na;
+    clone->frames[0].removed = -1;
+    clone->frames[0].hash = solver->frames[solver->depth].hash;
+    memcpy(clone->boardStates, solver->Nb, 2 * solver->boards * sizeof(int));
+    selectFrame(clone);
 
-        n = llCreateNode(cpy);
-        expectNotNull(n);
+    clone->order = NULL;
+    resetSearch(clone);
 
-        llInsertLast(solver->Sg, n);
-        solver->Ng++;
-        fgetc(f_guesses); // chomp \n character to get to new line
-    }
-    if (ferror(f_guesses)) {
-        fprintf(stderr, "Une erreur est survenue lors de la lecture du ficher %s: %s", guesses_file, strerror(errno));
-        exit(EXIT_FAILURE);
+    return clone;
+}
+
+
+void solverSetStrategy(Solver *solver, SolverStrategy strategy)
+{
+    solver->strategy = strategy;
+    resetSearch(solver);
+}
+
+
+SolverStrategy solverGetStrategy(Solver *solver)
+{
+    return solver->boards == 1 ? solver->strategy : SOLVER_AVERAGE;
+}
+
+
+void solverSetMetric(Solver *solver, Metric metric)
+{
+    solver->metric = metric;
+    solver->score = metricFunction(metric);
+    resetSearch(solver);
+}
+
+
+Metric solverGetMetric(Solver *solver)
+{
+    return solver->metric;
+}
+
+
+void solverSetSampling(Solver *solver, int size, uint64_t seed)
+{
+    solver->sampleSize = size;
+    solver->seed = seed;
+    resetSearch(solver);
+}
+
+
+int solverIsSampled(Solver *solver)
+{
+    return solver->sampleSize > 1 && solver->boards == 1
+        && solver->Na > 2 * solver->sampleSize
+        && solverGetStrategy(solver) == SOLVER_AVERAGE
+        && !solverIsApproximate(solver)
+        && metricIntervalFunction(solver->metric) != NULL;
+}
+
+
+void solverGetSample(Solver *solver, SolverSample *sample)
+{
+    *sample = solver->sample;
+}
+
+
+void solverSetIncremental(Solver *solver, int incremental)
+{
+    solver->incremental = incremental;
+    if (!incremental) {
+        memoryFree(solver->kept);
+        solver->kept = NULL;
     }
+    resetSearch(solver);
+}
 
-    return solver;
+
+void solverSetApproximate(Solver *solver, int approximate)
+{
+    solver->approximate = approximate;
+    resetSearch(solver);
 }
 
 
-void solverFree(Solver *solver)
+int solverIsApproximate(Solver *solver)
+{
+    return solver->approximate && solverGetStrategy(solver) == SOLVER_AVERAGE;
+}
+
+
+void solverSetTransposition(Solver *solver, Transposition *table)
 {
-    llFreeData(solver->Sa);
-    llFreeData(solver->Sg);
-    free(solver);
+    solver->table = table;
+}
+
+
+uint64_t solverStateKey(Solver *solver)
+{
+    return solver->frames[solver->depth].hash;
 }
 
 
 int solverGetNbAnswers(Solver *solver)
 {
-    return (int)llLength(solver->Sa);
+    return solver->Na;
+}
+
+
+int solverGetNbGuesses(Solver *solver)
+{
+    return solver->Ng;
+}
+
+
+void solverPatternCounts(Solver *solver, char *guess, int *histogram)
+{
+    int g = partitionFindGuess(solver->engine, guess);
+
+    memset(histogram, 0, PATTERN_COUNT * sizeof(int));
+    for (int i = 0; i < solver->Na; i++) {
+        if (g < 0) {
+            int code = wordlePatternCode(guess, partitionAnswer(solver->engine, solver->Sa[i]));
+            if (code >= 0)
+                histogram[code]++;
+        } else
+            histogram[partitionPattern(solver->engine, g, solver->Sa[i])]++;
+    }
+}
+
+
+int solverGetNbBoards(Solver *solver)
+{
+    return solver->boards;
+}
+
+
+int solverGetNbAnswersOnBoard(Solver *solver, int board)
+{
+    return solver->solved[board] ? 0 : solver->Nb[board];
 }
 
 
 int solverUpdate(Solver *solver, char *guess, char *pattern)
 {
-    int pattern_eq (void *a, void *b) {
-        char *p = wordleComputePattern((char*)a, guess);
-        if (0 == strcmp(p, (char*) b)) {
-            free(p);
-            return 1;
+    assert(solver->boards == 1);
+
+    return solverUpdateBoards(solver, guess, &pattern);
+}
+
+
+int solverUpdateBoards(Solver *solver, char *guess, char **patterns)
+{
+    int g = partitionFindGuess(solver->engine, guess);
+    int before = solver->Na;
+    int codes[solver->boards];
+    int i, b;
+
+    if (solver->frozen) {
+        releaseShared(solver->frozen);
+        solver->frozen = NULL;
+    }
+
+    // The new frame starts as a copy of the board states of the current one
+    reserveFrame(solver);
+    Frame *frame = &solver->frames[solver->depth + 1];
+    int *Nb = solver->boardStates + (size_t)(solver->depth + 1) * 2 * solver->boards;
+    int *solved = Nb + solver->boards;
+    memcpy(Nb, solver->Nb, 2 * solver->boards * sizeof(int));
+
+    for (b = 0; b < solver->boards; b++) {
+        if (solved[b])
+            continue;
+
+        codes[b] = wordlePatternFromString(patterns[b]);
+        if (codes[b] == PATTERN_SOLVED)
+            solved[b] = 1;
+        Nb[b] = 0;
+    }
+
+    // The ordering is only valid for the current possible answers
+    resetSearch(solver);
+
+    // Removing chosen guess from the valid guesses, by swapping it past the
+    // end so that the removal can be undone
+    frame->removed = -1;
+    for (i = 0; i < solver->Ng; i++) {
+        if (solver->Sg[i] == g) {
+            if (!solver->ownsSg) {
+                int *Sg = memoryAlloc(MEMORY_SOLVER, (solver->Ng + 1) * sizeof(int));
+                expectNotNull(Sg);
+                memcpy(Sg, solver->Sg, solver->Ng * sizeof(int));
+                solver->Sg = Sg;
+                solver->ownsSg = 1;
+            }
+            solver->Sg[i] = solver->Sg[solver->Ng - 1];
+            solver->Sg[solver->Ng - 1] = g;
+            solver->Ng--;
+            frame->removed = i;
+            break;
         }
-        free(p);
-        return 0;
     }
 
-    int equals (void *a, void *b) {
-        return 0 == strcmp((char*)a, (char*)b);
+    // Boards are sorted segments of the merged array, solved ones drop out.
+    // Survivors are written after the current frame, which stays intact.
+    frame->start = frameEnd(solver);
+    frame->hash = 0;
+    int *Sa = solver->arena + frame->start;
+    int *base = solver->arenaBase + frame->start;
+    int end, n, kept;
+
+    for (i = 0, kept = 0; i < solver->Na; i = end) {
+        b = solver->base[i] / PATTERN_COUNT;
+        for (end = i; end < solver->Na && solver->base[end] == solver->base[i]; end++)
+            ;
+
+        if (solved[b])
+            continue;
+
+        memcpy(Sa + kept, solver->Sa + i, (end - i) * sizeof(int));
+        if (g < 0)
+            n = splitByWord(solver, guess, Sa + kept, end - i, codes[b]);
+        else
+            n = partitionSplit(solver->engine, g, Sa + kept, end - i, codes[b]);
+
+        for (int k = kept; k < kept + n; k++) {
+            base[k] = b * PATTERN_COUNT;
+            frame->hash ^= partitionAnswerKey(solver->engine, b, Sa[k]);
+        }
+        Nb[b] = n;
+        kept += n;
     }
+    frame->Na = kept;
 
-    // Removing chosen guess from the List
-    llFilter(solver->Sg, equals, guess, 0, 1);
+    solver->depth++;
+    selectFrame(solver);
 
-    return llFilter(solver->Sa, pattern_eq, pattern, 0, 1);
+    return before - solver->Na;
+}
+
+
+int solverSnapshot(Solver *solver)
+{
+    return solver->depth;
+}
+
+
+void solverRestore(Solver *solver, int snapshot)
+{
+    assert(0 <= snapshot && snapshot <= solver->depth);
+
+    if (snapshot == solver->depth)
+        return;
+
+    if (solver->frozen) {
+        releaseShared(solver->frozen);
+        solver->frozen = NULL;
+    }
+
+    for (; solver->depth > snapshot; solver->depth--) {
+        int i = solver->frames[solver->depth].removed;
+        if (i >= 0) {
+            int g = solver->Sg[solver->Ng];
+            solver->Sg[solver->Ng] = solver->Sg[i];
+            solver->Sg[i] = g;
+            solver->Ng++;
+        }
+    }
+
+    selectFrame(solver);
+    resetSearch(solver);
 }
 
 
 double solverBestGuess(Solver *solver, char *guess)
+{
+    return solverBestGuessWithin(solver, guess, -1, NULL);
+}
+
+
+double solverBestGuessWithin(Solver *solver, char *guess, long budget_ms,
+                             SolverProgress *progress)
 {
     assert(NULL != solver);
-    assert(NULL != llHead(solver->Sg));
-    assert(NULL != llHead(solver->Sa));
+    assert(0 < solver->Ng);
+    assert(0 < solver->Na);
     assert(NULL != guess);
 
-    if (llLength(solver->Sa) == 1) {
-        strncpy(guess, llData(llHead(solver->Sa)), WORD_LENGTH);
-        return 0.;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    int total = searchSize(solver);
+    solver->sample.size = 0;
+
+    // A board down to one possible answer is solved by playing it
+    for (int i = 0; i < solver->Na; i++) {
+        if (solver->Nb[solver->base[i] / PATTERN_COUNT] == 1) {
+            strcpy(guess, partitionAnswer(solver->engine, solver->Sa[i]));
+            if (progress) {
+                progress->scanned = progress->total = total;
+                progress->complete = 1;
+            }
+            return 0.;
+        }
+    }
+
+    if (solverGetStrategy(solver) == SOLVER_MINIMAX) {
+        int guesses;
+        int g = minimaxBestGuess(solver->engine, solver->Sa, solver->Na,
+                                 budget_ms, solver->table, &guesses);
+        strcpy(guess, partitionGuess(solver->engine, g));
+        if (progress) {
+            progress->scanned = guesses > 0 ? total : 0;
+            progress->total = total;
+            progress->complete = guesses > 0;
+        }
+        return guesses;
+    }
+
+    // A state met before, by this solver or another sharing its table
+    int cached;
+    if (solver->table && solver->scanned == 0
+        && transpositionLookup(solver->table, searchKey(solver),
+                               solver->Na, &cached, &solver->bestScore)) {
+        solver->best = cached;
+        solver->scanned = total;
+    }
+
+    if (solver->scanned == 0 && solverIsSampled(solver)) {
+        solver->bestScore = sampledSearch(solver);
+        solver->scanned = total;
+        if (progress) {
+            progress->scanned = progress->total = total;
+            progress->complete = 1;
+        }
+        strcpy(guess, partitionGuess(solver->engine, solver->best));
+        return solver->bestScore;
+    }
+
+    int scanned = solver->scanned;
+    int count;
+
+    // Kept histograms are brought up to date at once, which a budget
+    // may not allow
+    if (scanned < total && budget_ms < 0)
+        syncHistograms(solver);
+
+    if (scanned < total) {
+        solverPrepareSearch(solver);
+        if (solver->histograms == NULL) {
+            solver->histograms = memoryAlloc(MEMORY_SOLVER, solver->tile * solver->boards * PATTERN_COUNT * sizeof(int));
+            expectNotNull(solver->histograms);
+        }
+    }
+
+    while (solver->scanned < total) {
+        count = total - solver->scanned;
+        if (count > solver->tile)
+            count = solver->tile;
+
+        scoreTile(solver, solver->order + solver->scanned, count,
+                  solver->histograms, &solver->bestScore, &solver->best, NULL);
+        solver->scanned += count;
+
+        if (budget_ms >= 0 && elapsedMs(&start) >= budget_ms)
+            break;
+    }
+
+    if (progress) {
+        progress->scanned = solver->scanned;
+        progress->total = total;
+        progress->complete = solver->scanned == total;
+    }
+
+    if (solver->table && scanned < total && solver->scanned == total)
+        transpositionStore(solver->table, searchKey(solver),
+                           solver->Na, solver->best, solver->bestScore);
+
+    strcpy(guess, partitionGuess(solver->engine, solver->best));
+
+    return solver->bestScore;
+}
+
+
+void solverPrepareSearch(Solver *solver)
+{
+    if (solver->order == NULL)
+        orderGuesses(solver);
+}
+
+
+double solverBestGuessInRange(Solver *solver, int from, int to, char *guess)
+{
+    assert(NULL != solver->order);
+
+    double bestScore = -1;
+    int best = -1;
+    int count;
+
+    int *histograms = memoryAlloc(MEMORY_SOLVER, solver->tile * solver->boards * PATTERN_COUNT * sizeof(int));
+    expectNotNull(histograms);
+
+    for (int k = from; k < to; k += count) {
+        count = to - k < solver->tile ? to - k : solver->tile;
+        scoreTile(solver, solver->order + k, count, histograms, &bestScore,
+                  &best, NULL);
     }
 
-    char *bestGuess = NULL;
-    char *guess_i = NULL;
-    char *answer_i = NULL;
-    char *pattern = NULL;
-    Dict *patternDict = NULL;
+    memoryFree(histograms);
+
+    if (best >= 0)
+        strcpy(guess, partitionGuess(solver->engine, best));
+
+    return bestScore;
+}
+
+
+int solverTopGuesses(Solver *solver, int n, char **guesses, double *scores)
+{
+    assert(0 < solver->Na);
+    assert(0 < n);
+
+    solverPrepareSearch(solver);
+    syncHistograms(solver);
+
+    Ranking ranking;
+    ranking.size = 0;
+    ranking.capacity = n < solver->Ng ? n : solver->Ng;
+    ranking.heap = memoryAlloc(MEMORY_SOLVER, ranking.capacity * sizeof(RankedScore));
+    int *histograms = memoryAlloc(MEMORY_SOLVER, solver->tile * solver->boards * PATTERN_COUNT * sizeof(int));
+    expectNotNull(ranking.heap);
+    expectNotNull(histograms);
+
     double bestScore = -1;
-    double score = 0;
-    int mismatches;
+    int best = -1;
+    int count;
+
+    for (int k = 0; k < solver->Ng; k += count) {
+        count = solver->Ng - k < solver->tile ? solver->Ng - k : solver->tile;
+        scoreTile(solver, solver->order + k, count, histograms, &bestScore,
+                  &best, &ranking);
+    }
+
+    // Only the kept guesses are sorted
+    qsort(ranking.heap, ranking.size, sizeof(RankedScore), compareScores);
+    for (int k = 0; k < ranking.size; k++) {
+        strcpy(guesses[k], partitionGuess(solver->engine, ranking.heap[k].guess));
+        scores[k] = ranking.heap[k].score;
+    }
+
+    // The pass scored every guess: the anytime search is complete
+    solver->scanned = solver->Ng;
+    solver->best = best;
+    solver->bestScore = bestScore;
+    if (solver->table)
+        transpositionStore(solver->table, searchKey(solver), solver->Na,
+                           best, bestScore);
+
+    memoryFree(histograms);
+    memoryFree(ranking.heap);
+
+    return ranking.size;
+}
+
+
+/**
+ * @brief Scores a tile of guesses and keeps the first one beating `bestScore`,
+ * and the best ones in `ranking` if not NULL.
+ */
+static void scoreTile(Solver *solver, const int *guesses, int count,
+                      int *histograms, double *bestScore, int *best,
+                      Ranking *ranking)
+{
+    size_t stride = (size_t)solver->boards * PATTERN_COUNT;
+    double score;
+
+    if (!solver->synced)
+        partitionHistogramTiled(solver->engine, guesses, count, solver->Sa,
+                                solver->base, solver->Na, histograms,
+                                solver->boards);
+
+    for (int k = 0; k < count; k++) {
+        if (solver->synced)
+            score = scoreHistograms(solver, solver->kept + guesses[k] * stride);
+        else
+            score = scoreHistograms(solver, histograms + k * stride);
 
-    int pattern_ne(void *a, void *b) {
-        char *pattern = wordleComputePattern((char*)a, guess_i);
-        if (0 != strcmp(pattern, (char*)b)) {
-            free(pattern);
-            return 1;
+        if (ranking)
+            rankingPush(ranking, score, (int)(guesses + k - solver->order),
+                        guesses[k]);
+
+        if (*bestScore < score) {
+            *bestScore = score;
+            *best = guesses[k];
         }
-        free(pattern);
+    }
+}
+
+
+static void rankingPush(Ranking *ranking, double score, int rank, int guess)
+{
+    RankedScore entry = {score, rank, guess};
+    RankedScore *heap = ranking->heap;
+    int i, child;
+
+    if (ranking->size < ranking->capacity) {
+        // Sifting up from a new leaf
+        for (i = ranking->size++; i > 0 && isWorse(&entry, &heap[(i - 1) / 2]); i = (i - 1) / 2)
+            heap[i] = heap[(i - 1) / 2];
+        heap[i] = entry;
+        return;
+    }
+
+    if (!isWorse(&heap[0], &entry))
+        return;
+
+    // Replacing the worst one and sifting down from the root
+    for (i = 0; (child = 2 * i + 1) < ranking->size; i = child) {
+        if (child + 1 < ranking->size && isWorse(&heap[child + 1], &heap[child]))
+            child++;
+        if (!isWorse(&heap[child], &entry))
+            break;
+        heap[i] = heap[child];
+    }
+    heap[i] = entry;
+}
+
+
+/**
+ * @brief 1 if `a` ranks after `b`: a lower score, or the same score met later.
+ */
+static int isWorse(const RankedScore *a, const RankedScore *b)
+{
+    return a->score < b->score || (a->score == b->score && a->rank > b->rank);
+}
+
+
+static int compareScores(const void *a, const void *b)
+{
+    return isWorse(a, b) - isWorse(b, a);
+}
+
+
+static void allocateFrames(Solver *solver, size_t arenaSize, int maxDepth)
+{
+    solver->arenaSize = arenaSize;
+    solver->arena = memoryAlloc(MEMORY_SOLVER, arenaSize * sizeof(int));
+    solver->arenaBase = memoryAlloc(MEMORY_SOLVER, arenaSize * sizeof(int));
+    solver->maxDepth = maxDepth;
+    solver->frames = memoryAlloc(MEMORY_SOLVER, maxDepth * sizeof(Frame));
+    solver->boardStates = memoryAlloc(MEMORY_SOLVER, (size_t)maxDepth * 2 * solver->boards * sizeof(int));
+    expectNotNull(solver->arena);
+    expectNotNull(solver->arenaBase);
+    expectNotNull(solver->frames);
+    expectNotNull(solver->boardStates);
+
+    solver->depth = 0;
+}
+
+
+/**
+ * @brief Makes room for one more frame, of at most as many answers as the
+ * current one. Buffers grow geometrically, so a branch of updates and
+ * restores reuses them without allocating.
+ */
+static void reserveFrame(Solver *solver)
+{
+    size_t needed = frameEnd(solver) + (size_t)solver->Na;
+
+    if (needed > solver->arenaSize) {
+        solver->arenaSize = 2 * needed;
+        solver->arena = memoryRealloc(MEMORY_SOLVER, solver->arena, solver->arenaSize * sizeof(int));
+        solver->arenaBase = memoryRealloc(MEMORY_SOLVER, solver->arenaBase, solver->arenaSize * sizeof(int));
+        expectNotNull(solver->arena);
+        expectNotNull(solver->arenaBase);
+    }
+
+    if (solver->depth + 1 >= solver->maxDepth) {
+        solver->maxDepth *= 2;
+        solver->frames = memoryRealloc(MEMORY_SOLVER, solver->frames, solver->maxDepth * sizeof(Frame));
+        solver->boardStates = memoryRealloc(MEMORY_SOLVER, solver->boardStates,
+            (size_t)solver->maxDepth * 2 * solver->boards * sizeof(int));
+        expectNotNull(solver->frames);
+        expectNotNull(solver->boardStates);
+    }
+
+    selectFrame(solver);
+}
+
+
+/**
+ * @brief Points Sa, base, Na, Nb and solved to the current frame.
+ */
+static void selectFrame(Solver *solver)
+{
+    Frame *frame = &solver->frames[solver->depth];
+
+    if (solver->depth == 0 && solver->shared) {
+        solver->Sa = solver->shared->Sa;
+        solver->base = solver->shared->base;
+    }
+    else {
+        solver->Sa = solver->arena + frame->start;
+        solver->base = solver->arenaBase + frame->start;
+    }
+    solver->Na = frame->Na;
+    solver->Nb = solver->boardStates + (size_t)solver->depth * 2 * solver->boards;
+    solver->solved = solver->Nb + solver->boards;
+}
+
+
+/**
+ * @brief Position in the arenas where the frame after the current one starts.
+ */
+static size_t frameEnd(Solver *solver)
+{
+    if (solver->depth == 0 && solver->shared)
         return 0;
+
+    return solver->frames[solver->depth].start + solver->Na;
+}
+
+
+/**
+ * @brief Get the current state of a solver as a shared state, frozen once
+ * until the next update or restore. A clone still in its first state
+ * hands out the state it was cloned from.
+ */
+static SharedState *freeze(Solver *solver)
+{
+    if (solver->frozen)
+        return solver->frozen;
+
+    if (solver->depth == 0 && solver->shared && !solver->ownsSg) {
+        __atomic_add_fetch(&solver->shared->owners, 1, __ATOMIC_SEQ_CST);
+        solver->frozen = solver->shared;
+        return solver->frozen;
     }
 
-    Node *na;
-    for (Node *ng = llHead(solver->Sg); ng != NULL; ng = llNext(ng)) {
-        score = 0.;
-        guess_i = llData(ng);
-        patternDict = dictCreate(PATTERN_COUNT);
-        expectNotNull(patternDict);
+    // One block: the header, then Sa, base and Sg
+    size_t words = 2 * (size_t)solver->Na + solver->Ng;
+    SharedState *state = memoryAlloc(MEMORY_SOLVER, sizeof(SharedState) + words * sizeof(int));
+    expectNotNull(state);
+
+    state->owners = 1;
+    state->Sa = (int *)(state + 1);
+    state->base = state->Sa + solver->Na;
+    state->Sg = state->base + solver->Na;
+    state->Na = solver->Na;
+    state->Ng = solver->Ng;
+    memcpy(state->Sa, solver->Sa, solver->Na * sizeof(int));
+    memcpy(state->base, solver->base, solver->Na * sizeof(int));
+    memcpy(state->Sg, solver->Sg, solver->Ng * sizeof(int));
+
+    solver->frozen = state;
+    return state;
+}
+
+
+static void releaseShared(SharedState *state)
+{
+    if (__atomic_sub_fetch(&state->owners, 1, __ATOMIC_SEQ_CST) == 0)
+        memoryFree(state);
+}
+
 
-        for (na = llHead(solver->Sa); na != NULL; na = llNext(na)) {
-            answer_i = llData(na);
-            mismatches = 0;
-            pattern = wordleComputePattern(answer_i, guess_i);
+/**
+ * @brief partitionSplit for a guess that is not among the engine's guesses.
+ */
+static int splitByWord(Solver *solver, const char *guess, int *answers,
+                       int n, int code)
+{
+    int kept = 0;
+
+    for (int i = 0; i < n; i++)
+        if (wordlePatternCode(guess, partitionAnswer(solver->engine, answers[i])) == code)
+            answers[kept++] = answers[i];
+
+    return kept;
+}
+
+
+/**
+ * @brief Score of a guess by the solver's metric, computed from the
+ * partition of Sa by its patterns (one histogram per board) and summed
+ * over the unsolved boards.
+ */
+static double scoreHistograms(Solver *solver, const int *histograms)
+{
+    double score = 0.;
+    for (int b = 0; b < solver->boards; b++)
+        if (!solver->solved[b])
+            score += solver->score(histograms + b * PATTERN_COUNT, solver->Nb[b]);
+
+    return score;
+}
+
+
+/**
+ * @brief Scores every guess on a sample of the possible answers, drawn by a
+ * partial Fisher-Yates shuffle seeded by the state, then scores exactly
+ * those whose interval overlaps the leader's, in the priority order.
+ *
+ * @return the exact score of the best guess, stored in solver->best.
+ */
+static double sampledSearch(Solver *solver)
+{
+    MetricInterval interval = metricIntervalFunction(solver->metric);
+    int m = solver->sampleSize, n = solver->Na;
+    uint64_t state = solver->seed ^ solver->frames[solver->depth].hash;
+    int k, count;
 
-            if (dictContains(patternDict, pattern)) {
-                free(pattern);
-                continue;
+    int *sample = memoryAlloc(MEMORY_SOLVER, n * sizeof(int));
+    int *offsets = memoryCalloc(MEMORY_SOLVER, m, sizeof(int));
+    double *high = memoryAlloc(MEMORY_SOLVER, solver->Ng * sizeof(double));
+    int *candidates = memoryAlloc(MEMORY_SOLVER, solver->Ng * sizeof(int));
+    expectNotNull(sample);
+    expectNotNull(offsets);
+    expectNotNull(high);
+    expectNotNull(candidates);
+
+    memcpy(sample, solver->Sa, n * sizeof(int));
+    for (int i = 0; i < m; i++) {
+        int j = i + (int)(nextRandom(&state) % (uint64_t)(n - i));
+        int swap = sample[i];
+        sample[i] = sample[j];
+        sample[j] = swap;
+    }
+
+    // Answers in increasing order, as the tiled counting expects
+    qsort(sample, m, sizeof(int), compareInts);
+
+    solverPrepareSearch(solver);
+    if (solver->histograms == NULL) {
+        solver->histograms = memoryAlloc(MEMORY_SOLVER, solver->tile * PATTERN_COUNT * sizeof(int));
+        expectNotNull(solver->histograms);
+    }
+
+    SolverSample *leader = &solver->sample;
+    leader->size = m;
+    leader->estimate = -1.;
+    for (k = 0; k < solver->Ng; k += count) {
+        count = solver->Ng - k < solver->tile ? solver->Ng - k : solver->tile;
+        partitionHistogramTiled(solver->engine, solver->order + k, count,
+                                sample, offsets, m, solver->histograms, 1);
+
+        for (int t = 0; t < count; t++) {
+            double estimate, low;
+            interval(solver->histograms + t * PATTERN_COUNT, m, n,
+                     SOLVER_SAMPLE_Z, &estimate, &low, &high[k + t]);
+            if (estimate > leader->estimate) {
+                leader->estimate = estimate;
+                leader->low = low;
+                leader->high = high[k + t];
             }
+        }
+    }
+
+    leader->candidates = 0;
+    for (k = 0; k < solver->Ng; k++)
+        if (high[k] >= leader->low)
+            candidates[leader->candidates++] = solver->order[k];
+
+    double bestScore = -1;
+    solver->best = -1;
+    for (k = 0; k < leader->candidates; k += count) {
+        count = leader->candidates - k < solver->tile ? leader->candidates - k : solver->tile;
+        scoreTile(solver, candidates + k, count, solver->histograms,
+                  &bestScore, &solver->best, NULL);
+    }
+
+    memoryFree(sample);
+    memoryFree(offsets);
+    memoryFree(high);
+    memoryFree(candidates);
+
+    return bestScore;
+}
+
+
+/**
+ * @brief splitmix64: good enough a generator for samples, and seeded by a
+ * single word.
+ */
+static uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+    return z ^ (z >> 31);
+}
 
-            mismatches = llFilter(solver->Sa, pattern_ne, pattern, 1, 0);
 
-            dictInsert(patternDict, pattern, mismatches);
+/**
+ * @brief Brings the kept histograms of an incremental solver to its current
+ * answers, for an exhaustive search. When the answers are a subset of
+ * those they were counted for (after updates) or a superset (after a
+ * restore), and fewer answers changed than are left, only the changed
+ * ones are counted out or back in. Otherwise every guess is counted again.
+ */
+static void syncHistograms(Solver *solver)
+{
+    Partition *engine = solver->engine;
+    int Ng = partitionNbGuesses(engine);
+    size_t stride = (size_t)solver->boards * PATTERN_COUNT;
+    int changed = -1, sign = -1;
 
-            score += mismatches;
+    if (!solver->incremental || solver->synced || solverIsApproximate(solver)
+        || solverGetStrategy(solver) != SOLVER_AVERAGE
+        || Ng * stride * sizeof(int) > PARTITION_TABLES_MAX_BYTES)
+        return;
 
-            free(pattern);
+    int larger = solver->Na > solver->keptNa ? solver->Na : solver->keptNa;
+    int *changedSa = memoryAlloc(MEMORY_SOLVER, (larger + 1) * sizeof(int));
+    int *changedBase = memoryAlloc(MEMORY_SOLVER, (larger + 1) * sizeof(int));
+    expectNotNull(changedSa);
+    expectNotNull(changedBase);
+
+    if (solver->kept) {
+        changed = changedAnswers(solver->keptSa, solver->keptBase, solver->keptNa,
+                                 solver->Sa, solver->base, solver->Na,
+                                 changedSa, changedBase);
+        if (changed < 0) {
+            sign = 1;
+            changed = changedAnswers(solver->Sa, solver->base, solver->Na,
+                                     solver->keptSa, solver->keptBase,
+                                     solver->keptNa, changedSa, changedBase);
         }
+    }
 
-        score /= solver->Na;
-        if (bestScore < score) {
-            bestScore = score;
-            bestGuess = guess_i;
+    if (changed >= 0 && changed < solver->Na) {
+        for (int g = 0; g < Ng; g++) {
+            int *histograms = solver->kept + g * stride;
+            for (int i = 0; i < changed; i++)
+                histograms[changedBase[i] + partitionPattern(engine, g, changedSa[i])] += sign;
+        }
+    }
+    else {
+        if (solver->kept == NULL) {
+            solver->kept = memoryAlloc(MEMORY_SOLVER, Ng * stride * sizeof(int));
+            expectNotNull(solver->kept);
         }
 
-        dictFree(patternDict);
+        int guesses[64];
+        for (int g = 0, count; g < Ng; g += count) {
+            count = Ng - g < 64 ? Ng - g : 64;
+            for (int k = 0; k < count; k++)
+                guesses[k] = g + k;
+            partitionHistogramTiled(engine, guesses, count, solver->Sa,
+                                    solver->base, solver->Na,
+                                    solver->kept + g * stride, solver->boards);
+        }
     }
 
-    strncpy(guess, bestGuess, WORD_LENGTH);
+    memoryFree(changedSa);
+    memoryFree(changedBase);
 
-    return bestScore;
+    solver->keptSa = memoryRealloc(MEMORY_SOLVER, solver->keptSa, solver->Na * sizeof(int));
+    solver->keptBase = memoryRealloc(MEMORY_SOLVER, solver->keptBase, solver->Na * sizeof(int));
+    expectNotNull(solver->keptSa);
+    expectNotNull(solver->keptBase);
+    memcpy(solver->keptSa, solver->Sa, solver->Na * sizeof(int));
+    memcpy(solver->keptBase, solver->base, solver->Na * sizeof(int));
+    solver->keptNa = solver->Na;
+    solver->synced = 1;
 }
 
 
+/**
+ * @brief Finds the answers of `from` missing from `to`, both sorted by
+ * offset then answer, as merged arrays are.
+ *
+ * @return their number, or -1 if `to` is not a subset of `from`.
+ */
+static int changedAnswers(const int *fromSa, const int *fromBase, int m,
+                          const int *toSa, const int *toBase, int n,
+                          int *changedSa, int *changedBase)
+{
+    int i, j = 0, changed = 0;
+
+    if (n > m)
+        return -1;
+
+    for (i = 0; i < m; i++) {
+        if (j < n && fromSa[i] == toSa[j] && fromBase[i] == toBase[j]) {
+            j++;
+            continue;
+        }
+        changedSa[changed] = fromSa[i];
+        changedBase[changed] = fromBase[i];
+        changed++;
+    }
+
+    return j == n ? changed : -1;
+}
+
+
+static void resetSearch(Solver *solver)
+{
+    solver->synced = 0;
+    solver->sample.size = 0;
+    memoryFree(solver->order);
+    solver->order = NULL;
+    solver->scanned = 0;
+    solver->best = -1;
+    solver->bestScore = -1;
+}
+
+
+/**
+ * @brief Number of guesses of Sg scored by a complete search: all of them,
+ * or the best ranked ones of an approximate search.
+ */
+static int searchSize(Solver *solver)
+{
+    if (!solverIsApproximate(solver))
+        return solver->Ng;
+
+    // Scoring a guess counts its patterns, then sums its buckets
+    long k = SOLVER_APPROX_WORK / (solver->Na + PATTERN_COUNT);
+    if (k < SOLVER_APPROX_MIN)
+        k = SOLVER_APPROX_MIN;
+
+    return k < solver->Ng ? (int)k : solver->Ng;
+}
+
+
+/**
+ * @brief Key of the current state in the table. Approximate searches get
+ * keys of their own, so that they do not answer exhaustive ones.
+ */
+static uint64_t searchKey(Solver *solver)
+{
+    uint64_t key = solver->frames[solver->depth].hash;
+
+    return solverIsApproximate(solver) ? key ^ 0x617070726f78ull : key;
+}
+
+
+/**
+ * @brief Sorts Sg by how frequent the letters of each guess are among the
+ * remaining answers, so that the anytime search meets good guesses first.
+ * For an approximate search, only the guesses it scores are sorted, after
+ * being selected in linear time; the others follow in no given order.
+ */
+static void orderGuesses(Solver *solver)
+{
+    long present[ALPHABET_MAX_LETTERS] = {0};
+    long placed[WORD_LENGTH][ALPHABET_MAX_LETTERS] = {{0}};
+    int i, j;
+
+    for (int k = 0; k < solver->Na; k++) {
+        const unsigned char *answer = partitionAnswerLetters(solver->engine, solver->Sa[k]);
+        for (i = 0; i < WORD_LENGTH; i++) {
+            placed[i][answer[i]]++;
+            // Count each distinct letter of the answer once
+            for (j = 0; j < i && answer[j] != answer[i]; j++)
+                ;
+            if (j == i)
+                present[answer[i]]++;
+        }
+    }
+
+    int total = solver->Ng;
+    RankedGuess *ranked = memoryAlloc(MEMORY_SOLVER, total * sizeof(RankedGuess));
+    expectNotNull(ranked);
+
+    int k;
+    for (k = 0; k < total; k++) {
+        const unsigned char *g = partitionGuessLetters(solver->engine, solver->Sg[k]);
+        ranked[k].guess = solver->Sg[k];
+        ranked[k].priority = 0;
+        for (i = 0; i < WORD_LENGTH; i++) {
+            ranked[k].priority += placed[i][g[i]];
+            for (j = 0; j < i && g[j] != g[i]; j++)
+                ;
+            if (j == i)
+                ranked[k].priority += present[g[i]];
+        }
+    }
+
+    int sorted = searchSize(solver);
+    if (sorted < total)
+        selectRanked(ranked, total, sorted);
+    qsort(ranked, sorted, sizeof(RankedGuess), compareRanked);
+
+    solver->order = memoryAlloc(MEMORY_SOLVER, total * sizeof(int));
+    expectNotNull(solver->order);
+    for (k = 0; k < total; k++)
+        solver->order[k] = ranked[k].guess;
+
+    memoryFree(ranked);
+}
+
+
+/**
+ * @brief Moves the k first guesses of the priority order to the front of
+ * `ranked` by quickselect, in any order.
+ */
+static void selectRanked(RankedGuess *ranked, int count, int k)
+{
+    int lo = 0, hi = count - 1;
+
+    while (lo < hi) {
+        // Median of three as pivot, then a Hoare partition around it
+        int mid = lo + (hi - lo) / 2;
+        RankedGuess pivot = ranked[mid], tmp;
+        if (compareRanked(&ranked[lo], &pivot) > 0 && compareRanked(&ranked[hi], &pivot) > 0)
+            pivot = compareRanked(&ranked[lo], &ranked[hi]) < 0 ? ranked[lo] : ranked[hi];
+        else if (compareRanked(&ranked[lo], &pivot) < 0 && compareRanked(&ranked[hi], &pivot) < 0)
+            pivot = compareRanked(&ranked[lo], &ranked[hi]) > 0 ? ranked[lo] : ranked[hi];
+
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (compareRanked(&ranked[i], &pivot) < 0)
+                i++;
+            while (compareRanked(&ranked[j], &pivot) > 0)
+                j--;
+            if (i <= j) {
+                tmp = ranked[i];
+                ranked[i++] = ranked[j];
+                ranked[j--] = tmp;
+            }
+        }
+
+        // [lo, j] comes first, [i, hi] last, and what lies between is in place
+        if (k - 1 <= j)
+            hi = j;
+        else if (k - 1 >= i)
+            lo = i;
+        else
+            return;
+    }
+}
+
+
+static int compareRanked(const void *a, const void *b)
+{
+    const RankedGuess *ra = a;
+    const RankedGuess *rb = b;
+
+    // Ties by index, so that the order does not depend on the order of Sg
+    if (ra->priority != rb->priority)
+        return (ra->priority < rb->priority) - (ra->priority > rb->priority);
+
+    return (ra->guess > rb->guess) - (ra->guess < rb->guess);
+}
+
+
+static int compareInts(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+
+    return (x > y) - (x < y);
+}
+
+
+static double elapsedMs(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec) * 1e3
+         + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
 
 static void expectNotNull(void *p) {
     if (p == NULL) {
@@ -1,11 +1,53 @@
 #ifndef SOLVER_H
 #define SOLVER_H
 
+#include <stdint.h>
+
+#include "transposition.h"
+#include "partition.h"
+#include "metric.h"
+
+#define SOLVER_APPROX_MIN (64)        // Fewest guesses scored by an approximate search
+#define SOLVER_APPROX_WORK (1L << 20) // Patterns counted by an approximate search
+#define SOLVER_SAMPLE_Z (3.)          // Half-width of the sampled intervals, in standard deviations
+
 /**
  * @brief Represents a solver.
  */
 typedef struct Solver_t Solver;
 
+/**
+ * @brief Progress of an anytime best-guess search.
+ */
+typedef struct SolverProgress_t
+{
+    int scanned;  // Number of guesses scored so far
+    int total;    // Number of guesses to score
+    int complete; // 1 if every guess has been scored
+} SolverProgress;
+
+/**
+ * @brief Sampling of the last best-guess search.
+ */
+typedef struct SolverSample_t
+{
+    int size;        // Answers sampled, 0 if the search was not sampled
+    int candidates;  // Guesses scored exactly, their intervals overlapping
+                     // the leader's
+    double estimate; // Estimated score of the leader of the sample
+    double low;      // Its confidence interval
+    double high;
+} SolverSample;
+
+/**
+ * @brief Criterion of the best guess.
+ */
+typedef enum
+{
+    SOLVER_AVERAGE, // Best score of the solver's metric (see metric.h)
+    SOLVER_MINIMAX  // Fewest guesses needed in the worst case (single board)
+} SolverStrategy;
+
 /**
  * @brief Creates a new solver.
  *
@@ -18,6 +60,47 @@ typedef struct Solver_t Solver;
  */
 Solver *solverStart(char *answers_file, char *guesses_file);
 
+/**
+ * @brief Creates a new solver playing several boards at once: every guess
+ * is played on all of them, each board hiding its own answer.
+ *
+ * @param answers_file Path to the file containing
+ * the possible answers.
+ * @param guesses_file Path to the file containing
+ * the accepted words.
+ * @param boards Number of boards.
+ *
+ * @return The created solver.
+ */
+Solver *solverStartBoards(char *answers_file, char *guesses_file, int boards);
+
+/**
+ * @brief Creates a new solver on an engine already loaded, which it takes
+ * over: the owner passed is released by solverFree. The engine's index is
+ * built if it has none yet, so an engine shared with other threads should
+ * be built before.
+ *
+ * @param engine The engine.
+ *
+ * @return The created solver.
+ */
+Solver *solverStartEngine(Partition *engine);
+
+/**
+ * @brief Creates an independent clone of a solver in its current state.
+ *
+ * The clone shares the word tables and a frozen copy of the current
+ * possible answers and guesses with the original; it copies them only when
+ * an update writes them, so many clones of a state cost little memory.
+ * Clones of one solver must be created by the thread using it, and can
+ * then be used and freed by other threads, in any order.
+ *
+ * @param solver Solver to clone.
+ *
+ * @return The clone.
+ */
+Solver *solverClone(Solver *solver);
+
 /**
  * @brief Frees a solver.
  *
@@ -25,18 +108,201 @@ Solver *solverStart(char *answers_file, char *guesses_file);
  */
 void solverFree(Solver *solver);
 
+/**
+ * @brief Sets the criterion of the best-guess search of a solver and of its
+ * future clones (SOLVER_AVERAGE by default). Solvers of several boards
+ * always use SOLVER_AVERAGE.
+ *
+ * With SOLVER_MINIMAX, the best-guess search returns the number of
+ * guesses, this one included, within which every possible answer is
+ * guaranteed to be solved (0 if no bound could be proven within the
+ * budget), and the search is complete once a bound is proven.
+ *
+ * @param solver the solver.
+ * @param strategy the criterion.
+ */
+void solverSetStrategy(Solver *solver, SolverStrategy strategy);
+
+/**
+ * @brief Get the criterion of the best-guess search.
+ *
+ * @param solver the solver.
+ *
+ * @return the strategy.
+ */
+SolverStrategy solverGetStrategy(Solver *solver);
+
+/**
+ * @brief Sets the metric scoring the guesses of SOLVER_AVERAGE searches of
+ * a solver and of its future clones (METRIC_EXPECTED by default). The
+ * histogram of each guess is counted once whatever the metric, and the
+ * scores returned by the searches are the metric's.
+ *
+ * @param solver the solver.
+ * @param metric the metric.
+ */
+void solverSetMetric(Solver *solver, Metric metric);
+
+/**
+ * @brief Get the metric of the best-guess search.
+ *
+ * @param solver the solver.
+ *
+ * @return the metric.
+ */
+Metric solverGetMetric(Solver *solver);
+
+/**
+ * @brief Makes the SOLVER_AVERAGE searches of a solver and of its future
+ * clones sampled, or exact again (size 0, the default).
+ *
+ * A sampled search scores every guess on a random sample of `size`
+ * possible answers, with a confidence interval of SOLVER_SAMPLE_Z
+ * standard deviations, then only scores exactly the guesses whose
+ * interval overlaps the one of the best estimate: with the exact guess
+ * scored too unless its estimate was far off, the choice rarely differs
+ * from an exhaustive search. The sample of a state only depends on the
+ * seed and on the possible answers, so searches are reproducible. Only
+ * searches of a single board, with more than twice `size` possible
+ * answers, not approximate, and by a metric that can be estimated (see
+ * metricIntervalFunction) are sampled; they ignore the time budget, and
+ * their results are not stored in the transposition table.
+ *
+ * @param solver the solver.
+ * @param size number of answers sampled (0 for exact searches).
+ * @param seed seed of the samples.
+ */
+void solverSetSampling(Solver *solver, int size, uint64_t seed);
+
+/**
+ * @brief Tells whether the next best-guess search of a solver is sampled.
+ *
+ * @param solver the solver.
+ *
+ * @return 1 if it is, 0 otherwise.
+ */
+int solverIsSampled(Solver *solver);
+
+/**
+ * @brief Get the sampling of the last best-guess search.
+ *
+ * @param solver the solver.
+ * @param sample filled with the sampling (of size 0 if none, or if the
+ * solver was updated since).
+ */
+void solverGetSample(Solver *solver, SolverSample *sample);
+
+/**
+ * @brief Makes a solver keep the histograms of every guess between moves,
+ * or stop keeping them (the default, and the state of clones). Exhaustive
+ * SOLVER_AVERAGE searches without a time budget then score the kept
+ * histograms, after counting out the answers removed since they were last
+ * brought up to date, or back in those restored, whenever fewer answers
+ * changed than are left: a move costs in proportion to what it changed.
+ * The histograms take Ng x boards x PATTERN_COUNT counters, so this suits
+ * a solver playing one game, rather than the many clones of a tournament.
+ *
+ * @param solver the solver.
+ * @param incremental 1 to keep the histograms, 0 to free them.
+ */
+void solverSetIncremental(Solver *solver, int incremental);
+
+/**
+ * @brief Makes the best-guess search of a solver and of its future clones
+ * approximate, or exhaustive again (the default). Only SOLVER_AVERAGE
+ * searches are approximated.
+ *
+ * An approximate search ranks the valid guesses by the letter and
+ * position frequencies of the possible answers, in O(Ng), and only scores
+ * the best ranked K ones. K is chosen so that about SOLVER_APPROX_WORK
+ * patterns are counted, and is at least SOLVER_APPROX_MIN: small sets of
+ * answers are still searched (almost) exhaustively.
+ *
+ * @param solver the solver.
+ * @param approximate 1 for an approximate search, 0 for an exhaustive one.
+ */
+void solverSetApproximate(Solver *solver, int approximate);
+
+/**
+ * @brief Tells if the best-guess search of a solver is approximate.
+ *
+ * @param solver the solver.
+ *
+ * @return 1 if approximate, 0 if exhaustive.
+ */
+int solverIsApproximate(Solver *solver);
+
+/**
+ * @brief Shares a transposition table with a solver and its future clones.
+ * Complete best-guess searches are stored in it, and looked up before
+ * searching a state again.
+ *
+ * @param solver the solver.
+ * @param table the table (NULL for none), which must outlive the solver
+ * and its clones.
+ */
+void solverSetTransposition(Solver *solver, Transposition *table);
+
+/**
+ * @brief Get the Zobrist hash of the possible answers of every board,
+ * maintained by the updates and restored with the states.
+ *
+ * @param solver the solver.
+ *
+ * @return the hash of the current state.
+ */
+uint64_t solverStateKey(Solver *solver);
+
 /**
  * @brief Get the number of possible answers.
  *
  * @param solver the solver.
  *
- * @return the number of possible answers.
+ * @return the number of possible answers, summed over the unsolved boards.
  */
 int solverGetNbAnswers(Solver *solver);
 
+/**
+ * @brief Get the number of guesses the best-guess search has to score.
+ *
+ * @param solver the solver.
+ *
+ * @return the number of valid guesses.
+ */
+int solverGetNbGuesses(Solver *solver);
+
+/**
+ * @brief Count how many possible answers, over all boards, would produce
+ * each pattern with a guess.
+ *
+ * @param solver the solver.
+ * @param guess the guess.
+ * @param histogram Array of PATTERN_COUNT counters, overwritten.
+ */
+void solverPatternCounts(Solver *solver, char *guess, int *histogram);
+
+/**
+ * @brief Get the number of boards.
+ *
+ * @param solver the solver.
+ *
+ * @return the number of boards.
+ */
+int solverGetNbBoards(Solver *solver);
+
+/**
+ * @brief Get the number of possible answers of a board.
+ *
+ * @param solver the solver.
+ * @param board index of the board.
+ *
+ * @return the number of possible answers, or 0 if the board is solved.
+ */
+int solverGetNbAnswersOnBoard(Solver *solver, int board);
+
 /**
  * @brief Update the list of possible answers given a
- * guess and a pattern.
+ * guess and a pattern (single board solver only).
  *
  * @param solver the solver.
  * @param guess the guess.
@@ -46,6 +312,40 @@ int solverGetNbAnswers(Solver *solver);
  */
 int solverUpdate(Solver *solver, char *guess, char *pattern);
 
+/**
+ * @brief Update the lists of possible answers of every board given a
+ * guess and the pattern seen on each board. Boards whose pattern is
+ * "ooooo" are solved and no longer taken into account.
+ *
+ * @param solver the solver.
+ * @param guess the guess.
+ * @param patterns the pattern of each board (ignored for solved boards).
+ *
+ * @return the number of removed possible answers.
+ */
+int solverUpdateBoards(Solver *solver, char *guess, char **patterns);
+
+/**
+ * @brief Marks the current state of the solver, to come back to it later.
+ *
+ * @param solver the solver.
+ *
+ * @return the snapshot, to pass to solverRestore.
+ */
+int solverSnapshot(Solver *solver);
+
+/**
+ * @brief Undoes every update made since a snapshot. Updates keep the states
+ * they replace, so restoring costs O(1) per undone update and allocates
+ * nothing. A solver created by solverClone cannot be restored to a state
+ * older than the copy.
+ *
+ * @param solver the solver.
+ * @param snapshot value returned by solverSnapshot, on this solver, since
+ * which no older snapshot has been restored.
+ */
+void solverRestore(Solver *solver, int snapshot);
+
 /**
  * @brief Get the best guess.
  *
@@ -56,4 +356,65 @@ int solverUpdate(Solver *solver, char *guess, char *pattern);
  */
 double solverBestGuess(Solver *solver, char *guess);
 
+/**
+ * @brief Get the best guess found within a time budget.
+ *
+ * Guesses are scored in decreasing order of a letter-frequency priority
+ * until the budget runs out, and the best one found so far is returned. An
+ * approximate search stops after the best ranked ones (see
+ * solverSetApproximate), and reports them as the total.
+ * The search resumes where it stopped when called again before the next
+ * solverUpdate, so repeated calls refine the answer until every guess
+ * has been scored.
+ *
+ * @param solver the solver.
+ * @param guess buffer to store the guess.
+ * @param budget_ms time budget in milliseconds (negative for no limit).
+ * At least one guess is always scored.
+ * @param progress if not NULL, filled with the coverage of the search.
+ *
+ * @return the score of the best guess found.
+ */
+double solverBestGuessWithin(Solver *solver, char *guess, long budget_ms,
+                             SolverProgress *progress);
+
+/**
+ * @brief Sorts the valid guesses in the priority order of the search. Called
+ * by solverBestGuessWithin, it must be called before solverBestGuessInRange.
+ *
+ * @param solver the solver.
+ */
+void solverPrepareSearch(Solver *solver);
+
+/**
+ * @brief Get the best guess among the guesses of positions [from, to) in the
+ * priority order, ties going to the earliest one. The solver is only read,
+ * so disjoint ranges can be scored by concurrent threads, and merging them
+ * gives the result of solverBestGuess.
+ *
+ * @param solver the solver.
+ * @param from first position to score.
+ * @param to position after the last one to score.
+ * @param guess buffer to store the guess (untouched if the range is empty).
+ *
+ * @return the score of the best guess, or -1 if the range is empty.
+ */
+double solverBestGuessInRange(Solver *solver, int from, int to, char *guess);
+
+/**
+ * @brief Get the best guesses with their scores, best first, ties going to
+ * the earliest in the priority order. Every guess is scored once, and only
+ * the best `n` are kept, in a bounded heap. The anytime search of the
+ * current state is complete afterwards.
+ *
+ * @param solver the solver.
+ * @param n number of guesses wanted.
+ * @param guesses n buffers of WORD_BYTES chars to store the guesses.
+ * @param scores array of n scores, filled in the order of `guesses`.
+ *
+ * @return the number of guesses stored (less than n if there are fewer
+ * valid guesses).
+ */
+int solverTopGuesses(Solver *solver, int n, char **guesses, double *scores);
+
 #endif
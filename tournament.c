@@ -0,0 +1,490 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tournament.h"
+#include "scheduler.h"
+#include "wordle.h"
+#include "memory.h"
+#include "shard.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+
+#define CHUNK_WORK (1 << 20) // Patterns counted by a scoring task of a large node
+#define SEQUENTIAL_ANSWERS (32) // Nodes this small are evaluated by a single task
+
+
+typedef struct TreeNode_t TreeNode;
+
+/**
+ * @brief Part of the guesses of a node, scored by its own task.
+ */
+typedef struct
+{
+    TreeNode *node;
+    int index;
+    double score;
+    char guess[WORD_BYTES];
+} Chunk;
+
+/**
+ * @brief Node of the decision tree: the games sharing the same first moves.
+ */
+struct TreeNode_t
+{
+    TournamentResult *result;
+    Solver *solver;              // State of the games at this node
+    int depth;                   // Number of guesses played before the node
+    char guess[WORD_BYTES]; // Guess played at this node ("" if not chosen yet)
+
+    Chunk *chunks;  // Parts of the guesses scored in parallel, or NULL
+    int nbChunks;
+    int remaining;  // Chunks not scored yet
+};
+
+/**
+ * @brief The first guess of a sharded tournament, and the shard playing
+ * each of its pattern buckets.
+ */
+typedef struct
+{
+    Solver *solver;
+    char guess[WORD_BYTES];
+    int threads;
+    int histogram[PATTERN_COUNT];
+    int owner[PATTERN_COUNT];
+} ShardedRoot;
+
+/**
+ * @brief One pattern of a what-if analysis, answered by its own task.
+ */
+typedef struct
+{
+    Solver *solver; // Clone to play the pattern on
+    char *guess;
+    int pattern;
+    WhatIfReply *reply;
+} WhatIf;
+
+
+static void expandNode(Scheduler *scheduler, void *arg);
+static void scoreChunk(Scheduler *scheduler, void *arg);
+static void spawnChildren(Scheduler *scheduler, TreeNode *node);
+static void evaluateSubtree(TournamentResult *result, Solver *solver,
+                            int depth, char *guess);
+static void chooseGuess(TournamentResult *result, Solver *solver, char *guess);
+static long elapsedUs(const struct timespec *start);
+static int recordBucket(TournamentResult *result, int pattern, int games,
+                        int depth);
+static TreeNode *createNode(TournamentResult *result, Solver *solver, int depth);
+static void record(TournamentResult *result, int guesses, int games);
+static void answerWhatIf(Scheduler *scheduler, void *arg);
+static void playShard(int shard, FILE *out, void *context);
+static void expectNotNull(void *p);
+
+
+TournamentResult tournamentRun(Solver *solver, char *first_guess, int threads)
+{
+    assert(solverGetNbBoards(solver) == 1);
+
+    TournamentResult result;
+    memset(&result, 0, sizeof(result));
+    result.games = solverGetNbAnswers(solver);
+
+    Scheduler *scheduler = schedulerCreate(threads);
+
+    TreeNode *root = createNode(&result, solverClone(solver), 0);
+    if (first_guess)
+        strncpy(root->guess, first_guess, WORD_BYTES - 1);
+
+    schedulerSpawn(scheduler, expandNode, root);
+    schedulerWait(scheduler);
+    schedulerFree(scheduler);
+
+    return result;
+}
+
+
+TournamentResult tournamentRunShards(Solver *solver, char *first_guess,
+                                     int threads, int shards)
+{
+    assert(solverGetNbBoards(solver) == 1);
+
+    if (shards <= 1)
+        return tournamentRun(solver, first_guess, threads);
+
+    TournamentResult result;
+    memset(&result, 0, sizeof(result));
+    result.games = solverGetNbAnswers(solver);
+
+    ShardedRoot root;
+    root.solver = solver;
+    root.threads = threads;
+    if (first_guess)
+        snprintf(root.guess, WORD_BYTES, "%s", first_guess);
+    else
+        chooseGuess(&result, solver, root.guess);
+
+    solverPatternCounts(solver, root.guess, root.histogram);
+
+    shardDeal(root.histogram, PATTERN_COUNT, shards, root.owner);
+
+    FILE **files = shardRun(shards, playShard, &root);
+
+    for (int s = 0; s < shards; s++) {
+        TournamentResult part;
+        if (fread(&part, sizeof(part), 1, files[s]) != 1) {
+            fprintf(stderr, "Le résultat du shard %d n'a pas pu être lu.\n", s);
+            exit(EXIT_FAILURE);
+        }
+
+        result.guesses += part.guesses;
+        result.failures += part.failures;
+        for (int k = 0; k <= TOURNAMENT_MAX_GUESSES; k++)
+            result.counts[k] += part.counts[k];
+        result.decisions += part.decisions;
+        result.mismatches += part.mismatches;
+        result.approxUs += part.approxUs;
+        result.exhaustiveUs += part.exhaustiveUs;
+    }
+
+    shardClose(files, shards);
+
+    return result;
+}
+
+
+void tournamentWhatIf(Solver *solver, char *guess, int threads,
+                      WhatIfReply *replies)
+{
+    assert(solverGetNbBoards(solver) == 1);
+
+    int histogram[PATTERN_COUNT];
+    solverPatternCounts(solver, guess, histogram);
+
+    WhatIf *tasks = memoryAlloc(MEMORY_TOURNAMENT, PATTERN_COUNT * sizeof(WhatIf));
+    expectNotNull(tasks);
+
+    Scheduler *scheduler = schedulerCreate(threads);
+
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        replies[p].remaining = histogram[p];
+        replies[p].guess[0] = '\0';
+        replies[p].score = 0.;
+
+        if (histogram[p] == 0 || p == PATTERN_SOLVED)
+            continue;
+
+        tasks[p].solver = solverClone(solver);
+        tasks[p].guess = guess;
+        tasks[p].pattern = p;
+        tasks[p].reply = &replies[p];
+        schedulerSpawn(scheduler, answerWhatIf, &tasks[p]);
+    }
+
+    schedulerWait(scheduler);
+    schedulerFree(scheduler);
+    memoryFree(tasks);
+}
+
+
+/**
+ * @brief Chooses the guess of a node, directly for small nodes, or by
+ * spawning one scoring task per chunk of guesses for large ones.
+ */
+static void expandNode(Scheduler *scheduler, void *arg)
+{
+    TreeNode *node = arg;
+    int n = solverGetNbAnswers(node->solver);
+    int ng = solverGetNbGuesses(node->solver);
+
+    // Small subtrees are walked depth first by updating and restoring the
+    // node's solver, which is cheaper than a task and a copy per node
+    if (n <= SEQUENTIAL_ANSWERS && node->guess[0] == '\0') {
+        evaluateSubtree(node->result, node->solver, node->depth, NULL);
+        solverFree(node->solver);
+        memoryFree(node);
+        return;
+    }
+
+    if (node->guess[0] != '\0' || n == 1) {
+        if (node->guess[0] == '\0')
+            chooseGuess(node->result, node->solver, node->guess);
+        spawnChildren(scheduler, node);
+        return;
+    }
+
+    long chunks = (long)n * ng / CHUNK_WORK;
+    if (chunks > 4 * schedulerNbThreads(scheduler))
+        chunks = 4 * schedulerNbThreads(scheduler);
+    if (schedulerNbThreads(scheduler) == 1 || chunks > ng
+        || solverGetStrategy(node->solver) != SOLVER_AVERAGE
+        || solverIsApproximate(node->solver) || solverIsSampled(node->solver))
+        chunks = 1;
+
+    if (chunks <= 1) {
+        chooseGuess(node->result, node->solver, node->guess);
+        spawnChildren(scheduler, node);
+        return;
+    }
+
+    solverPrepareSearch(node->solver);
+
+    node->nbChunks = node->remaining = (int)chunks;
+    node->chunks = memoryAlloc(MEMORY_TOURNAMENT, chunks * sizeof(Chunk));
+    expectNotNull(node->chunks);
+
+    for (int i = 0; i < chunks; i++) {
+        node->chunks[i].node = node;
+        node->chunks[i].index = i;
+        schedulerSpawn(scheduler, scoreChunk, &node->chunks[i]);
+    }
+}
+
+
+/**
+ * @brief Scores a chunk of the guesses of a node. The last chunk to finish
+ * merges the chunks and expands the node.
+ */
+static void scoreChunk(Scheduler *scheduler, void *arg)
+{
+    Chunk *chunk = arg;
+    TreeNode *node = chunk->node;
+    int ng = solverGetNbGuesses(node->solver);
+
+    int from = (int)((long)ng * chunk->index / node->nbChunks);
+    int to = (int)((long)ng * (chunk->index + 1) / node->nbChunks);
+
+    chunk->score = solverBestGuessInRange(node->solver, from, to, chunk->guess);
+
+    if (__atomic_sub_fetch(&node->remaining, 1, __ATOMIC_ACQ_REL) > 0)
+        return;
+
+    // Ties go to the earliest chunk, as in a sequential search
+    int best = 0;
+    for (int i = 1; i < node->nbChunks; i++)
+        if (node->chunks[i].score > node->chunks[best].score)
+            best = i;
+
+    strcpy(node->guess, node->chunks[best].guess);
+    memoryFree(node->chunks);
+    node->chunks = NULL;
+
+    spawnChildren(scheduler, node);
+}
+
+
+/**
+ * @brief Plays the guess of a node against its possible answers, and spawns
+ * a task for every pattern bucket holding more than one answer.
+ */
+static void spawnChildren(Scheduler *scheduler, TreeNode *node)
+{
+    int histogram[PATTERN_COUNT];
+    char pattern[WORD_LENGTH + 1];
+    int depth = node->depth + 1;
+
+    solverPatternCounts(node->solver, node->guess, histogram);
+
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        if (recordBucket(node->result, p, histogram[p], depth)) {
+            Solver *child = solverClone(node->solver);
+            wordlePatternToString(p, pattern);
+            solverUpdate(child, node->guess, pattern);
+            schedulerSpawn(scheduler, expandNode,
+                           createNode(node->result, child, depth));
+        }
+    }
+
+    solverFree(node->solver);
+    memoryFree(node);
+}
+
+
+/**
+ * @brief Evaluates, in the calling task, the subtree of the games of a
+ * solver state reached after `depth` guesses. The solver is left as found.
+ */
+static void evaluateSubtree(TournamentResult *result, Solver *solver,
+                            int depth, char *guess)
+{
+    int histogram[PATTERN_COUNT];
+    char pattern[WORD_LENGTH + 1];
+    char chosen[WORD_BYTES] = {0};
+
+    if (guess == NULL) {
+        chooseGuess(result, solver, chosen);
+        guess = chosen;
+    }
+
+    solverPatternCounts(solver, guess, histogram);
+
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        if (recordBucket(result, p, histogram[p], depth + 1)) {
+            int snapshot = solverSnapshot(solver);
+            wordlePatternToString(p, pattern);
+            solverUpdate(solver, guess, pattern);
+            evaluateSubtree(result, solver, depth + 1, NULL);
+            solverRestore(solver, snapshot);
+        }
+    }
+}
+
+
+/**
+ * @brief Chooses the guess of a solver state. The choice of an approximate
+ * search is compared with the best of the guesses it did not score, which
+ * completes an exhaustive search.
+ */
+static void chooseGuess(TournamentResult *result, Solver *solver, char *guess)
+{
+    SolverProgress progress;
+    SolverSample sample;
+    struct timespec start;
+    char other[WORD_BYTES];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    double score = solverBestGuessWithin(solver, guess, -1, &progress);
+    solverGetSample(solver, &sample);
+
+    if ((!solverIsApproximate(solver) && sample.size == 0)
+        || solverGetNbAnswers(solver) == 1)
+        return;
+
+    long approx = elapsedUs(&start);
+
+    // Ties go to the guesses scored by the approximate search, as they
+    // come first in the priority order. A sampled search may have left out
+    // any guess.
+    solverPrepareSearch(solver);
+    int mismatch = solverBestGuessInRange(solver,
+                                          sample.size ? 0 : progress.total,
+                                          solverGetNbGuesses(solver),
+                                          other) > score;
+
+    __atomic_add_fetch(&result->decisions, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&result->mismatches, mismatch, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&result->approxUs, approx, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&result->exhaustiveUs, elapsedUs(&start), __ATOMIC_RELAXED);
+}
+
+
+static long elapsedUs(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec) * 1000000L
+         + (now.tv_nsec - start->tv_nsec) / 1000L;
+}
+
+
+/**
+ * @brief Records the games of a pattern bucket after `depth` guesses when
+ * their outcome is known.
+ *
+ * @return 1 if the bucket still has to be played.
+ */
+static int recordBucket(TournamentResult *result, int pattern, int games,
+                        int depth)
+{
+    if (games == 0)
+        return 0;
+
+    if (pattern == PATTERN_SOLVED)
+        record(result, depth, games);
+    else if (games == 1)
+        // Its only answer is played next
+        record(result, depth + 1, 1);
+    else if (depth >= TOURNAMENT_MAX_GUESSES)
+        record(result, TOURNAMENT_MAX_GUESSES + 1, games);
+    else
+        return 1;
+
+    return 0;
+}
+
+
+static void answerWhatIf(Scheduler *scheduler, void *arg)
+{
+    WhatIf *whatIf = arg;
+    char pattern[WORD_LENGTH + 1];
+
+    (void)scheduler;
+
+    wordlePatternToString(whatIf->pattern, pattern);
+    solverUpdate(whatIf->solver, whatIf->guess, pattern);
+    whatIf->reply->score = solverBestGuess(whatIf->solver, whatIf->reply->guess);
+
+    solverFree(whatIf->solver);
+}
+
+
+/**
+ * @brief Plays the pattern buckets of the first guess dealt to a shard, and
+ * writes the results of their games.
+ */
+static void playShard(int shard, FILE *out, void *context)
+{
+    ShardedRoot *root = context;
+    TournamentResult result;
+    char pattern[WORD_LENGTH + 1];
+
+    memset(&result, 0, sizeof(result));
+
+    Scheduler *scheduler = schedulerCreate(root->threads);
+
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        if (root->owner[p] == shard
+            && recordBucket(&result, p, root->histogram[p], 1)) {
+            Solver *child = solverClone(root->solver);
+            wordlePatternToString(p, pattern);
+            solverUpdate(child, root->guess, pattern);
+            schedulerSpawn(scheduler, expandNode, createNode(&result, child, 1));
+        }
+    }
+
+    schedulerWait(scheduler);
+    schedulerFree(scheduler);
+
+    fwrite(&result, sizeof(result), 1, out);
+}
+
+
+static TreeNode *createNode(TournamentResult *result, Solver *solver, int depth)
+{
+    TreeNode *node = memoryCalloc(MEMORY_TOURNAMENT, 1, sizeof(TreeNode));
+    expectNotNull(node);
+
+    node->result = result;
+    node->solver = solver;
+    node->depth = depth;
+
+    return node;
+}
+
+
+/**
+ * @brief Counts `games` games solved in `guesses` guesses.
+ */
+static void record(TournamentResult *result, int guesses, int games)
+{
+    if (guesses > TOURNAMENT_MAX_GUESSES) {
+        __atomic_add_fetch(&result->failures, games, __ATOMIC_RELAXED);
+        return;
+    }
+
+    __atomic_add_fetch(&result->counts[guesses], games, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&result->guesses, (long)guesses * games, __ATOMIC_RELAXED);
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include "solver.h"
+#include "wordle.h"
+
+#define TOURNAMENT_MAX_GUESSES (32) // Games still unsolved after this are failures
+
+/**
+ * @brief Outcome of the solver over every possible answer.
+ */
+typedef struct TournamentResult_t
+{
+    int games;    // Number of answers played
+    long guesses; // Total number of guesses of the solved games
+    int failures; // Games not solved within TOURNAMENT_MAX_GUESSES guesses
+    int counts[TOURNAMENT_MAX_GUESSES + 1]; // counts[k]: games solved in k guesses
+
+    // Guesses chosen by an approximate or sampled search (see
+    // solverSetApproximate and solverSetSampling)
+    int decisions;     // Number of guesses chosen
+    int mismatches;    // Of which an exhaustive search would have chosen another
+    long approxUs;     // Time spent choosing them, in microseconds
+    long exhaustiveUs; // Time an exhaustive search would have spent
+} TournamentResult;
+
+/**
+ * @brief What the solver does after one pattern of a what-if analysis.
+ */
+typedef struct WhatIfReply_t
+{
+    int remaining;               // Possible answers left by the pattern
+    char guess[WORD_BYTES]; // Next guess of the solver ("" if none)
+    double score;                // Score of `guess`
+} WhatIfReply;
+
+/**
+ * @brief Plays the solver against every possible answer of its current
+ * state.
+ *
+ * Games sharing their first moves share the solver's decisions, so the
+ * games are evaluated as the solver's decision tree: each node is a
+ * (game state, depth) task which picks the best guess once and spawns one
+ * task per pattern bucket, run by a work-stealing scheduler. The guesses
+ * of large nodes are scored by several tasks in parallel.
+ *
+ * With an approximate solver, every guess chosen is checked against the
+ * guesses the approximate search left out, so that the result counts the
+ * choices differing from an exhaustive search and the time each search
+ * takes. The check doubles as the rest of an exhaustive search, so the
+ * tournament itself runs at the exhaustive speed. Sampled searches are
+ * checked the same way, against every guess.
+ *
+ * @param solver the solver, with a single board (left untouched).
+ * @param first_guess forced first guess (NULL to let the solver choose).
+ * @param threads number of worker threads.
+ *
+ * @return the results of the games.
+ */
+TournamentResult tournamentRun(Solver *solver, char *first_guess, int threads);
+
+/**
+ * @brief Same as tournamentRun, with the games spread over processes: the
+ * first guess is chosen once, then its pattern buckets are dealt to the
+ * shards, largest first to the shard with the fewest games so far. Each
+ * shard plays its buckets with `threads` threads, and the results are
+ * summed. The solver's engine and table should be in shared mappings
+ * (see partitionMapShared and transpositionCreateShared), so that memory
+ * does not grow with the number of shards.
+ *
+ * @param solver the solver, with a single board (left untouched).
+ * @param first_guess forced first guess (NULL to let the solver choose).
+ * @param threads number of worker threads of each shard.
+ * @param shards number of processes.
+ *
+ * @return the results of the games.
+ */
+TournamentResult tournamentRunShards(Solver *solver, char *first_guess,
+                                     int threads, int shards);
+
+/**
+ * @brief Computes the solver's next move for every pattern a guess may get.
+ *
+ * Each pattern is played on its own clone of the solver by a task of a
+ * work-stealing scheduler; the clones share the solver's state until
+ * they update it.
+ *
+ * @param solver the solver, with a single board (left untouched).
+ * @param guess the guess whose patterns are analysed.
+ * @param threads number of worker threads.
+ * @param replies Array of PATTERN_COUNT replies, one per pattern code. The
+ * guess is empty for the patterns no possible answer gives, and for
+ * PATTERN_SOLVED.
+ */
+void tournamentWhatIf(Solver *solver, char *guess, int threads,
+                      WhatIfReply *replies);
+
+#endif
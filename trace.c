@@ -0,0 +1,266 @@
+#include "trace.h"
+#include "partition.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+
+#define TRACE_MAGIC "WTRC"
+#define TRACE_VERSION (1)
+
+#define TRACE_MINIMAX (1)     // Settings bit of the minimax strategy
+#define TRACE_APPROXIMATE (2) // Settings bit of the approximate search
+#define TRACE_METRIC_SHIFT (2) // Settings bits of the metric, above them
+#define TRACE_SAMPLED (0x80)  // Settings bit of the sampled search, whose
+                              // size and seed follow the settings
+
+
+struct Trace_t {
+    FILE *f;
+    const char *file;
+};
+
+
+static Trace *openTrace(const char *file, const char *mode);
+static void checkHeader(Trace *trace, char *answers_file, char *guesses_file);
+static void writeVarint(FILE *f, uint64_t value);
+static void writeWord(FILE *f, const char *word);
+static int readByte(Trace *trace);
+static uint64_t readVarint(Trace *trace);
+static void readWord(Trace *trace, char *word);
+static void corrupted(Trace *trace);
+static void expectNotNull(void *p);
+
+
+Trace *traceAppend(const char *file, char *answers_file, char *guesses_file)
+{
+    Trace *trace = openTrace(file, "a+b");
+
+    fseek(trace->f, 0, SEEK_END);
+    if (ftell(trace->f) > 0) {
+        rewind(trace->f);
+        checkHeader(trace, answers_file, guesses_file);
+        fseek(trace->f, 0, SEEK_END);
+        return trace;
+    }
+
+    Partition *p = partitionCreate(answers_file, guesses_file);
+    uint64_t fingerprint = partitionFingerprint(p);
+    partitionFree(p);
+
+    fwrite(TRACE_MAGIC, 1, strlen(TRACE_MAGIC), trace->f);
+    fputc(TRACE_VERSION, trace->f);
+    for (int i = 0; i < 8; i++)
+        fputc((int)(fingerprint >> (8 * i)) & 0xff, trace->f);
+    fflush(trace->f);
+
+    return trace;
+}
+
+
+Trace *traceOpen(const char *file, char *answers_file, char *guesses_file)
+{
+    Trace *trace = openTrace(file, "rb");
+    checkHeader(trace, answers_file, guesses_file);
+
+    return trace;
+}
+
+
+void traceWrite(Trace *trace, const TraceGame *game)
+{
+    int settings = (game->strategy == SOLVER_MINIMAX ? TRACE_MINIMAX : 0)
+                 | (game->approximate ? TRACE_APPROXIMATE : 0)
+                 | game->metric << TRACE_METRIC_SHIFT
+                 | (game->sample > 0 ? TRACE_SAMPLED : 0);
+
+    fputc(settings, trace->f);
+    if (game->sample > 0) {
+        writeVarint(trace->f, (uint64_t)game->sample);
+        writeVarint(trace->f, (uint64_t)game->seed);
+    }
+    writeWord(trace->f, game->answer);
+    fputc(game->nbMoves, trace->f);
+
+    for (int m = 0; m < game->nbMoves; m++) {
+        const TraceMove *move = &game->moves[m];
+        writeWord(trace->f, move->guess);
+        fputc(move->pattern, trace->f);
+        fputc(move->flags, trace->f);
+        writeVarint(trace->f, (uint64_t)move->latencyUs);
+    }
+
+    // A crash later in the session keeps the games already played
+    fflush(trace->f);
+}
+
+
+int traceRead(Trace *trace, TraceGame *game)
+{
+    int settings = fgetc(trace->f);
+    if (settings == EOF)
+        return 0;
+
+    game->strategy = settings & TRACE_MINIMAX ? SOLVER_MINIMAX : SOLVER_AVERAGE;
+    game->approximate = (settings & TRACE_APPROXIMATE) != 0;
+    game->metric = (Metric)((settings & ~TRACE_SAMPLED) >> TRACE_METRIC_SHIFT);
+    if (game->metric >= METRIC_KINDS)
+        corrupted(trace);
+
+    game->sample = 0;
+    game->seed = 0;
+    if (settings & TRACE_SAMPLED) {
+        uint64_t sample = readVarint(trace);
+        if (sample < 2 || sample > INT32_MAX)
+            corrupted(trace);
+        game->sample = (int)sample;
+        game->seed = (unsigned long)readVarint(trace);
+    }
+    readWord(trace, game->answer);
+
+    game->nbMoves = readByte(trace);
+    if (game->nbMoves > TRACE_MAX_MOVES)
+        corrupted(trace);
+
+    for (int m = 0; m < game->nbMoves; m++) {
+        TraceMove *move = &game->moves[m];
+        readWord(trace, move->guess);
+        move->pattern = readByte(trace);
+        if (move->pattern >= PATTERN_COUNT)
+            corrupted(trace);
+        move->flags = readByte(trace);
+        move->latencyUs = (long)readVarint(trace);
+    }
+
+    return 1;
+}
+
+
+void traceClose(Trace *trace)
+{
+    fclose(trace->f);
+    memoryFree(trace);
+}
+
+
+static Trace *openTrace(const char *file, const char *mode)
+{
+    FILE *f = fopen(file, mode);
+    if (f == NULL) {
+        fprintf(stderr, "Le fichier %s n'a pas pu être ouvert: %s\n", file, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    Trace *trace = memoryAlloc(MEMORY_TRACE, sizeof(Trace));
+    expectNotNull(trace);
+    trace->f = f;
+    trace->file = file;
+
+    return trace;
+}
+
+
+/**
+ * @brief Reads the header of a trace, and exits if it was not recorded
+ * with these word lists.
+ */
+static void checkHeader(Trace *trace, char *answers_file, char *guesses_file)
+{
+    char magic[sizeof(TRACE_MAGIC)] = {0};
+
+    if (fread(magic, 1, strlen(TRACE_MAGIC), trace->f) != strlen(TRACE_MAGIC)
+        || strcmp(magic, TRACE_MAGIC) != 0 || readByte(trace) != TRACE_VERSION) {
+        fprintf(stderr, "Le fichier %s n'est pas une trace de parties.\n", trace->file);
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t fingerprint = 0;
+    for (int i = 0; i < 8; i++)
+        fingerprint |= (uint64_t)readByte(trace) << (8 * i);
+
+    Partition *p = partitionCreate(answers_file, guesses_file);
+    uint64_t expected = partitionFingerprint(p);
+    partitionFree(p);
+
+    if (fingerprint != expected) {
+        fprintf(stderr, "Le fichier %s a été enregistré avec d'autres listes de mots.\n", trace->file);
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+/**
+ * @brief Writes 7 bits per byte, the high bit telling that more follow.
+ */
+static void writeVarint(FILE *f, uint64_t value)
+{
+    while (value >= 0x80) {
+        fputc((int)(value & 0x7f) | 0x80, f);
+        value >>= 7;
+    }
+    fputc((int)value, f);
+}
+
+
+static void writeWord(FILE *f, const char *word)
+{
+    size_t length = strlen(word);
+
+    fputc((int)length, f);
+    fwrite(word, 1, length, f);
+}
+
+
+static int readByte(Trace *trace)
+{
+    int c = fgetc(trace->f);
+    if (c == EOF)
+        corrupted(trace);
+
+    return c;
+}
+
+
+static uint64_t readVarint(Trace *trace)
+{
+    uint64_t value = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = readByte(trace);
+        value |= (uint64_t)(c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+            return value;
+    }
+
+    corrupted(trace);
+    return 0;
+}
+
+
+static void readWord(Trace *trace, char *word)
+{
+    int length = readByte(trace);
+
+    if (length >= WORD_BYTES || fread(word, 1, length, trace->f) != (size_t)length)
+        corrupted(trace);
+    word[length] = '\0';
+}
+
+
+static void corrupted(Trace *trace)
+{
+    fprintf(stderr, "Le fichier %s est tronqué ou corrompu.\n", trace->file);
+    exit(EXIT_FAILURE);
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
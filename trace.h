@@ -0,0 +1,93 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "wordle.h"
+#include "solver.h"
+
+#define TRACE_MAX_MOVES (32) // Longest game of a trace
+
+#define TRACE_SOLVER (1)   // Move chosen by a solver search
+#define TRACE_COMPLETE (2) // Search that scored every guess
+
+/**
+ * @brief Binary file of games, appended to by the games played and read
+ * back to replay them. It starts with a fingerprint of the word lists, and
+ * numbers are stored as varints, so a game takes a few dozen bytes.
+ */
+typedef struct Trace_t Trace;
+
+/**
+ * @brief Move of a traced game.
+ */
+typedef struct TraceMove_t
+{
+    char guess[WORD_BYTES]; // Guess played
+    int pattern;            // Pattern code it got
+    int flags;              // TRACE_SOLVER and TRACE_COMPLETE
+    long latencyUs;         // Time the solver took to choose it (0 if not chosen by the solver)
+} TraceMove;
+
+/**
+ * @brief Traced game.
+ */
+typedef struct TraceGame_t
+{
+    char answer[WORD_BYTES]; // Hidden word (the last one left if adversarial)
+    SolverStrategy strategy; // Criterion of the solver's guesses
+    Metric metric;           // Metric of its SOLVER_AVERAGE searches
+    int approximate;         // 1 if the solver only scored the guesses ranked best
+    int sample;              // Answers its scores were estimated on (0 if exact)
+    unsigned long seed;      // Seed of the samples (if sample > 0)
+    int nbMoves;
+    TraceMove moves[TRACE_MAX_MOVES];
+} TraceGame;
+
+/**
+ * @brief Opens a trace to append games to, creating it if needed.
+ *
+ * @param file Path to the trace.
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ *
+ * @return The trace. Exits if it was recorded with other word lists.
+ */
+Trace *traceAppend(const char *file, char *answers_file, char *guesses_file);
+
+/**
+ * @brief Opens a trace to read its games from the first one.
+ *
+ * @param file Path to the trace.
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ *
+ * @return The trace. Exits if it was recorded with other word lists.
+ */
+Trace *traceOpen(const char *file, char *answers_file, char *guesses_file);
+
+/**
+ * @brief Appends a game to a trace, flushed to the file at once.
+ *
+ * @param trace Trace opened by traceAppend.
+ * @param game The game.
+ */
+void traceWrite(Trace *trace, const TraceGame *game);
+
+/**
+ * @brief Reads the next game of a trace.
+ *
+ * @param trace Trace opened by traceOpen.
+ * @param game Filled with the game.
+ *
+ * @return 1 if a game was read, 0 at the end of the trace. Exits if the
+ * trace is truncated or corrupted.
+ */
+int traceRead(Trace *trace, TraceGame *game);
+
+/**
+ * @brief Closes a trace.
+ *
+ * @param trace The trace.
+ */
+void traceClose(Trace *trace);
+
+#endif
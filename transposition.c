@@ -0,0 +1,203 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "transposition.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+
+
+#define TRANSPOSITION_STRIPES (64) // Locks shared by the sets, by index
+
+
+typedef struct
+{
+    uint64_t key;
+    int size;       // Number of answers of the set, 0 for a free entry
+    int guess;
+    double score;
+    unsigned long used; // Clock of the last store or hit, for eviction
+} Entry;
+
+struct Transposition_t {
+    Entry *entries;   // sets x TRANSPOSITION_WAYS entries
+    size_t sets;      // Power of two
+    int shared;       // 1 if mapped by transpositionCreateShared
+    unsigned long clock;
+    pthread_mutex_t locks[TRANSPOSITION_STRIPES];
+    TranspositionStats stats;
+};
+
+
+static Transposition *createTable(size_t bytes, int shared);
+static Entry *findSet(Transposition *table, uint64_t key,
+                      pthread_mutex_t **lock);
+static void expectNotNull(void *p);
+
+
+Transposition *transpositionCreate(size_t bytes)
+{
+    return createTable(bytes, 0);
+}
+
+
+Transposition *transpositionCreateShared(size_t bytes)
+{
+    return createTable(bytes, 1);
+}
+
+
+void transpositionFree(Transposition *table)
+{
+    for (int s = 0; s < TRANSPOSITION_STRIPES; s++)
+        pthread_mutex_destroy(&table->locks[s]);
+
+    if (table->shared) {
+        memoryUnmapShared(table->entries);
+        memoryUnmapShared(table);
+    } else {
+        memoryFree(table->entries);
+        memoryFree(table);
+    }
+}
+
+
+int transpositionLookup(Transposition *table, uint64_t key, int size,
+                        int *guess, double *score)
+{
+    pthread_mutex_t *lock;
+    Entry *set = findSet(table, key, &lock);
+    int found = 0;
+
+    pthread_mutex_lock(lock);
+    for (int w = 0; w < TRANSPOSITION_WAYS; w++) {
+        if (set[w].size == size && set[w].key == key) {
+            *guess = set[w].guess;
+            *score = set[w].score;
+            set[w].used = __atomic_add_fetch(&table->clock, 1, __ATOMIC_RELAXED);
+            found = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(lock);
+
+    __atomic_add_fetch(found ? &table->stats.hits : &table->stats.misses, 1,
+                       __ATOMIC_RELAXED);
+
+    return found;
+}
+
+
+void transpositionStore(Transposition *table, uint64_t key, int size,
+                        int guess, double score)
+{
+    pthread_mutex_t *lock;
+    Entry *set = findSet(table, key, &lock);
+
+    pthread_mutex_lock(lock);
+
+    // The entry of the key if present, else a free one, else the least
+    // recently used one
+    Entry *victim = &set[0];
+    for (int w = 0; w < TRANSPOSITION_WAYS; w++) {
+        if (set[w].size == size && set[w].key == key) {
+            victim = &set[w];
+            break;
+        }
+        if (victim->size != 0 && (set[w].size == 0 || set[w].used < victim->used))
+            victim = &set[w];
+    }
+
+    if (victim->size != 0 && (victim->size != size || victim->key != key))
+        __atomic_add_fetch(&table->stats.evictions, 1, __ATOMIC_RELAXED);
+
+    victim->key = key;
+    victim->size = size;
+    victim->guess = guess;
+    victim->score = score;
+    victim->used = __atomic_add_fetch(&table->clock, 1, __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock(lock);
+
+    __atomic_add_fetch(&table->stats.stores, 1, __ATOMIC_RELAXED);
+}
+
+
+TranspositionStats transpositionStats(Transposition *table)
+{
+    TranspositionStats stats;
+
+    stats.hits = __atomic_load_n(&table->stats.hits, __ATOMIC_RELAXED);
+    stats.misses = __atomic_load_n(&table->stats.misses, __ATOMIC_RELAXED);
+    stats.stores = __atomic_load_n(&table->stats.stores, __ATOMIC_RELAXED);
+    stats.evictions = __atomic_load_n(&table->stats.evictions, __ATOMIC_RELAXED);
+
+    return stats;
+}
+
+
+/**
+ * @brief Creates a table, on the heap or in a shared mapping. The locks of
+ * a shared table synchronize processes as well as threads.
+ */
+static Transposition *createTable(size_t bytes, int shared)
+{
+    size_t sets = 1;
+    while (2 * sets * TRANSPOSITION_WAYS * sizeof(Entry) <= bytes)
+        sets *= 2;
+
+    Transposition *table;
+    if (shared) {
+        table = memoryMapShared(MEMORY_TRANSPOSITION, sizeof(Transposition));
+        expectNotNull(table);
+        table->entries = memoryMapShared(MEMORY_TRANSPOSITION,
+                                         sets * TRANSPOSITION_WAYS * sizeof(Entry));
+    } else {
+        table = memoryAlloc(MEMORY_TRANSPOSITION, sizeof(Transposition));
+        expectNotNull(table);
+        table->entries = memoryCalloc(MEMORY_TRANSPOSITION,
+                                      sets * TRANSPOSITION_WAYS, sizeof(Entry));
+    }
+    expectNotNull(table->entries);
+
+    table->sets = sets;
+    table->shared = shared;
+    table->clock = 0;
+
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    if (shared)
+        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    for (int s = 0; s < TRANSPOSITION_STRIPES; s++)
+        pthread_mutex_init(&table->locks[s], &attributes);
+    pthread_mutexattr_destroy(&attributes);
+
+    table->stats.hits = table->stats.misses = 0;
+    table->stats.stores = table->stats.evictions = 0;
+
+    return table;
+}
+
+
+/**
+ * @brief Get the set of a key and the lock guarding it. The low bits of
+ * Zobrist keys are as random as the others.
+ */
+static Entry *findSet(Transposition *table, uint64_t key,
+                      pthread_mutex_t **lock)
+{
+    size_t set = (size_t)(key & (table->sets - 1));
+
+    *lock = &table->locks[set % TRANSPOSITION_STRIPES];
+
+    return table->entries + set * TRANSPOSITION_WAYS;
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
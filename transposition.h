@@ -0,0 +1,92 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRANSPOSITION_WAYS (4) // Entries of a set, among which one is evicted
+
+/**
+ * @brief Represents a bounded table of solver decisions, keyed by the hash
+ * of a set of possible answers. It can be shared by threads.
+ *
+ * The table is set associative: a key can only be stored in the
+ * TRANSPOSITION_WAYS entries of its set, and storing a new key in a full
+ * set evicts its least recently used entry.
+ */
+typedef struct Transposition_t Transposition;
+
+/**
+ * @brief Counters of the use of a table.
+ */
+typedef struct TranspositionStats_t
+{
+    long hits;      // Lookups which found their key
+    long misses;    // Lookups which did not
+    long stores;    // Keys stored
+    long evictions; // Keys evicted to store another one
+} TranspositionStats;
+
+/**
+ * @brief Creates an empty table.
+ *
+ * @param bytes Memory budget of the entries (at least one set is allocated).
+ *
+ * @return The created table.
+ */
+Transposition *transpositionCreate(size_t bytes);
+
+/**
+ * @brief Creates an empty table shared with the processes forked
+ * afterwards: what one stores, the others find, and the entries take the
+ * same memory however many processes use them.
+ *
+ * @param bytes Memory budget of the entries (at least one set is allocated).
+ *
+ * @return The created table.
+ */
+Transposition *transpositionCreateShared(size_t bytes);
+
+/**
+ * @brief Frees a table.
+ *
+ * @param table Table to free.
+ */
+void transpositionFree(Transposition *table);
+
+/**
+ * @brief Looks up the decision stored for a set of possible answers.
+ *
+ * @param table The table.
+ * @param key Hash of the set.
+ * @param size Number of answers in the set, checked against the entry.
+ * @param guess Filled with the guess stored (an engine guess index).
+ * @param score Filled with its score.
+ *
+ * @return 1 if found, 0 otherwise.
+ */
+int transpositionLookup(Transposition *table, uint64_t key, int size,
+                        int *guess, double *score);
+
+/**
+ * @brief Stores the decision taken for a set of possible answers.
+ *
+ * @param table The table.
+ * @param key Hash of the set.
+ * @param size Number of answers in the set.
+ * @param guess The guess chosen (an engine guess index).
+ * @param score Its score.
+ */
+void transpositionStore(Transposition *table, uint64_t key, int size,
+                        int guess, double score);
+
+/**
+ * @brief Get the counters of a table.
+ *
+ * @param table The table.
+ *
+ * @return the counters since the table was created.
+ */
+TranspositionStats transpositionStats(Transposition *table);
+
+#endif
@@ -0,0 +1,178 @@
+#include "tree.h"
+#include "memory.h"
+#include "alphabet.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+
+#define TREE_LINE_LENGTH (1024) // Longest line of a tree file
+
+
+struct DecisionNode_t {
+    char guess[WORD_BYTES];
+    DecisionNode **children; // PATTERN_COUNT children, or NULL for a leaf
+};
+
+struct DecisionTree_t {
+    DecisionNode *root;
+};
+
+
+static DecisionNode *createNode(void);
+static void freeNode(DecisionNode *node);
+static void invalidLine(const char *file, int line);
+static void expectNotNull(void *p);
+
+
+DecisionTree *decisionTreeLoad(const char *file, const Partition *p)
+{
+    FILE *f = fopen(file, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Le fichier %s n'a pas pu être ouvert: %s\n", file, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    DecisionTree *tree = memoryAlloc(MEMORY_TREE, sizeof(DecisionTree));
+    expectNotNull(tree);
+    tree->root = createNode();
+
+    char line[TREE_LINE_LENGTH];
+    int number = 0;
+    while (fgets(line, sizeof(line), f)) {
+        number++;
+
+        DecisionNode *node = tree->root;
+        int solved = 0;
+        char *guess = strtok(line, " \n");
+        if (guess == NULL)
+            continue;
+
+        // Pairs of a guess and its pattern, down to the answer
+        for (; guess; guess = strtok(NULL, " \n")) {
+            char *pattern = strtok(NULL, " \n");
+            int code = pattern ? wordlePatternFromString(pattern) : -1;
+
+            if (solved || code < 0 || alphabetWordLength(guess) != WORD_LENGTH)
+                invalidLine(file, number);
+            if (partitionFindGuess(p, guess) < 0) {
+                fprintf(stderr, "Le mot %s de la ligne %d du fichier %s n'est pas un mot accepté.\n",
+                        guess, number, file);
+                exit(EXIT_FAILURE);
+            }
+
+            if (node->guess[0] == '\0')
+                strcpy(node->guess, guess);
+            else if (strcmp(node->guess, guess) != 0)
+                invalidLine(file, number);
+
+            if (code == PATTERN_SOLVED) {
+                solved = 1;
+                continue;
+            }
+
+            if (node->children == NULL) {
+                node->children = memoryCalloc(MEMORY_TREE, PATTERN_COUNT, sizeof(DecisionNode *));
+                expectNotNull(node->children);
+            }
+            if (node->children[code] == NULL)
+                node->children[code] = createNode();
+            node = node->children[code];
+        }
+
+        if (!solved)
+            invalidLine(file, number);
+    }
+
+    fclose(f);
+
+    if (tree->root->guess[0] == '\0') {
+        fprintf(stderr, "Le fichier %s ne contient aucun arbre.\n", file);
+        exit(EXIT_FAILURE);
+    }
+
+    return tree;
+}
+
+
+void decisionTreeFree(DecisionTree *tree)
+{
+    freeNode(tree->root);
+    memoryFree(tree);
+}
+
+
+DecisionNode *decisionTreeRoot(DecisionTree *tree)
+{
+    return tree->root;
+}
+
+
+const char *decisionNodeGuess(const DecisionNode *node)
+{
+    return node->guess;
+}
+
+
+DecisionNode *decisionNodeChild(const DecisionNode *node, const char *pattern)
+{
+    int code = wordlePatternFromString(pattern);
+
+    if (code < 0 || node->children == NULL)
+        return NULL;
+
+    return node->children[code];
+}
+
+
+void decisionTreeWritePath(FILE *out, char (*guesses)[WORD_BYTES],
+                           const int *patterns, int length)
+{
+    char pattern[WORD_LENGTH + 1];
+
+    for (int i = 0; i < length; i++) {
+        wordlePatternToString(patterns[i], pattern);
+        fprintf(out, i + 1 < length ? "%s %s " : "%s %s\n", guesses[i], pattern);
+    }
+}
+
+
+static DecisionNode *createNode(void)
+{
+    DecisionNode *node = memoryAlloc(MEMORY_TREE, sizeof(DecisionNode));
+    expectNotNull(node);
+
+    node->guess[0] = '\0';
+    node->children = NULL;
+
+    return node;
+}
+
+
+static void freeNode(DecisionNode *node)
+{
+    if (node->children) {
+        for (int code = 0; code < PATTERN_COUNT; code++)
+            if (node->children[code])
+                freeNode(node->children[code]);
+        memoryFree(node->children);
+    }
+    memoryFree(node);
+}
+
+
+static void invalidLine(const char *file, int line)
+{
+    fprintf(stderr, "Ligne %d du fichier %s invalide.\n", line, file);
+    exit(EXIT_FAILURE);
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
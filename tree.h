@@ -0,0 +1,85 @@
+#ifndef TREE_H
+#define TREE_H
+
+#include "wordle.h"
+#include "partition.h"
+
+#include <stdio.h>
+
+/**
+ * @brief Represents a decision tree telling which guess to play after the
+ * patterns seen so far, as written by the optimize mode.
+ *
+ * A tree file has one line per answer: the guesses played to find it, each
+ * followed by the pattern it got, separated by spaces. The last guess of a
+ * line is the answer itself, followed by "ooooo":
+ *
+ *     roate _*___ sculk ___*_ light ooooo
+ */
+typedef struct DecisionTree_t DecisionTree;
+
+/**
+ * @brief Node of a decision tree: a state of the game and its guess.
+ */
+typedef struct DecisionNode_t DecisionNode;
+
+/**
+ * @brief Loads a decision tree from a file. Every word of the tree must be
+ * accepted by the engine, so that a tree written for other word lists is
+ * rejected.
+ *
+ * @param file Path to the tree file.
+ * @param p Engine of the word lists the tree is played with.
+ *
+ * @return The loaded tree.
+ */
+DecisionTree *decisionTreeLoad(const char *file, const Partition *p);
+
+/**
+ * @brief Frees a decision tree and its nodes.
+ *
+ * @param tree Tree to free.
+ */
+void decisionTreeFree(DecisionTree *tree);
+
+/**
+ * @brief Get the node of the first guess.
+ *
+ * @param tree The tree.
+ *
+ * @return the root node.
+ */
+DecisionNode *decisionTreeRoot(DecisionTree *tree);
+
+/**
+ * @brief Get the guess to play at a node.
+ *
+ * @param node The node.
+ *
+ * @return the guess.
+ */
+const char *decisionNodeGuess(const DecisionNode *node);
+
+/**
+ * @brief Get the node reached when the guess of a node gets a pattern.
+ *
+ * @param node The node.
+ * @param pattern The pattern obtained ('_', '*', 'o').
+ *
+ * @return the next node, or NULL if the tree does not expect the pattern
+ * (or if it solves the game).
+ */
+DecisionNode *decisionNodeChild(const DecisionNode *node, const char *pattern);
+
+/**
+ * @brief Writes the line of an answer to a tree file.
+ *
+ * @param out Stream to write to.
+ * @param guesses The guesses played, the answer last.
+ * @param patterns The pattern codes they got, PATTERN_SOLVED last.
+ * @param length Number of guesses.
+ */
+void decisionTreeWritePath(FILE *out, char (*guesses)[WORD_BYTES],
+                           const int *patterns, int length);
+
+#endif
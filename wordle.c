@@ -1,5 +1,8 @@
 #include "wordle.h"
 #include "LinkedList.h"
+#include "partition.h"
+#include "memory.h"
+#include "alphabet.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -14,6 +17,11 @@
 struct Wordle_t {
     char* trueWord;
     List* guesses;
+
+    // Adversarial games only (NULL otherwise)
+    Partition* engine; // Answers, accepted guesses and their patterns
+    int* live;         // Answers consistent with every pattern given
+    int nlive;         // Number of answers in `live`
 };
 
 //static void print_each(List* ll) {
@@ -26,20 +34,22 @@ struct Wordle_t {
 
 
 static unsigned get_random(unsigned limit);
+static char *check_guess_adversarial(Wordle *game, char *guess);
+static int read_word(FILE *f, char *word);
+static void check_null_on_init_w(void *p);
+
+static const int wordlePow3[WORD_LENGTH] = {1, 3, 9, 27, 81};
 
 
 Wordle *wordleStart(char *answers_file, char *guesses_file, char *answer)
 {
-    const void check_null_on_init_w (void* p) {
-        if (p == NULL) {
-            perror("Impossible de lancer le jeu:");
-            exit(EXIT_FAILURE);
-        }
-    }
-
-    Wordle *wordle = malloc(sizeof(Wordle));
+    Wordle *wordle = memoryAlloc(MEMORY_WORDLE, sizeof(Wordle));
     check_null_on_init_w(wordle);
 
+    wordle->engine = NULL;
+    wordle->live = NULL;
+    wordle->nlive = 0;
+
     // Loading list of possible guesses
 
     FILE *f_guesses = fopen(guesses_file, "r");
@@ -57,11 +67,13 @@ Wordle *wordleStart(char *answers_file, char *guesses_file, char *answer)
 
     while (1) {
 
-        buf = malloc((WORD_LENGTH + 1) * sizeof(char));
+        buf = memoryAlloc(MEMORY_WORDLE, WORD_BYTES * sizeof(char));
         check_null_on_init_w(buf);
 
-        if (fgets(buf, WORD_LENGTH + 1, f_guesses) == NULL)
+        if (!read_word(f_guesses, buf)) {
+            memoryFree(buf);
             break;
+        }
 
         node = llCreateNode(buf);
         check_null_on_init_w(node);
@@ -71,14 +83,12 @@ Wordle *wordleStart(char *answers_file, char *guesses_file, char *answer)
         #ifdef DEBUG
             guess_count++;
         #endif // DEBUG
-
-        // Chomp '\n' character
-        fgetc(f_guesses);
     }
     if (ferror(f_guesses)) {
         fprintf(stderr, "Une erreur est survenue lors de la lecture du ficher %s: %s", guesses_file, strerror(errno));
         exit(EXIT_FAILURE);
     }
+    fclose(f_guesses);
 
     // If no `answer` is given, take a word randomly from `answers_file`
     size_t word_count = 0;
@@ -92,17 +102,10 @@ Wordle *wordleStart(char *answers_file, char *guesses_file, char *answer)
             exit(EXIT_FAILURE);
         }
 
-        // Counting number of words in `guesses_file`
-        char c;
-        while (1) {
-            c = fgetc(f_answers);
-
-            if (c == EOF)
-                break;
-
-            if(c == '\n' || c == ' ')
-                ++word_count;
-        }
+        // Counting number of words in `answers_file`
+        char word[WORD_BYTES];
+        while (read_word(f_answers, word))
+            ++word_count;
         if (ferror(f_answers)) {
             fprintf(stderr, "Une erreur est survenue lors de la lecture du ficher %s: %s", answers_file, strerror(errno));
             exit(EXIT_FAILURE);
@@ -117,50 +120,86 @@ Wordle *wordleStart(char *answers_file, char *guesses_file, char *answer)
                 printf("DEBUG MODE: Random line is %ld\n", random_line);
         #endif // DEBUG
 
-        // Moving cursor to random word to choose as answer for the game
-        if (0 != fseek(f_answers, (WORD_LENGTH + 1) * random_line, SEEK_SET)) {
-            fprintf(stderr, "Une erreur est survenue lors de la lecture du ficher %s: %s", answers_file, strerror(errno));
-            exit(EXIT_FAILURE);
-        }
+        // Lines have no fixed width in UTF-8: the words before the random
+        // one are read again
+        rewind(f_answers);
 
         // reading `answer` inside the wordle object
-        wordle->trueWord = malloc((WORD_LENGTH + 1) * sizeof(char));
+        wordle->trueWord = memoryAlloc(MEMORY_WORDLE, WORD_BYTES * sizeof(char));
+        check_null_on_init_w(wordle->trueWord);
 
-        fgets(wordle->trueWord, WORD_LENGTH + 1, f_answers);
+        for (long int line = 0; line <= random_line; line++) {
+            if (!read_word(f_answers, wordle->trueWord)) {
+                fprintf(stderr, "Une erreur est survenue lors de la lecture du ficher %s: %s", answers_file, strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+        }
+        fclose(f_answers);
     }
     else {
         // Verify the integrity of the word's length
-        if (strlen(answer) != WORD_LENGTH) {
+        if (alphabetWordLength(answer) != WORD_LENGTH) {
             printf("Le mot %s n'est pas composé d'exactement %d lettres", answer, WORD_LENGTH);
             exit(EXIT_FAILURE);
         }
 
-        wordle->trueWord = answer;
+        // Own a copy, since wordleFree releases the true word
+        wordle->trueWord = memoryAlloc(MEMORY_WORDLE, WORD_BYTES * sizeof(char));
+        check_null_on_init_w(wordle->trueWord);
+        strcpy(wordle->trueWord, answer);
     }
 
     return wordle;
 }
 
 
+Wordle *wordleStartAdversarial(char *answers_file, char *guesses_file)
+{
+    Wordle *wordle = memoryAlloc(MEMORY_WORDLE, sizeof(Wordle));
+    if (wordle == NULL) {
+        perror("Impossible de lancer le jeu:");
+        exit(EXIT_FAILURE);
+    }
+
+    wordle->trueWord = NULL;
+    wordle->guesses = NULL;
+    wordle->engine = partitionCreate(answers_file, guesses_file);
+    wordle->nlive = partitionNbAnswers(wordle->engine);
+    wordle->live = memoryAlloc(MEMORY_WORDLE, wordle->nlive * sizeof(int));
+    if (wordle->live == NULL) {
+        perror("Impossible de lancer le jeu:");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int a = 0; a < wordle->nlive; a++)
+        wordle->live[a] = a;
+
+    return wordle;
+}
+
+
 void wordleFree(Wordle *game) {
-    free(game->trueWord);
-    llFreeData(game->guesses);
-    free(game);
+    memoryFree(game->trueWord);
+    if (game->guesses)
+        llFreeData(game->guesses);
+    if (game->engine)
+        partitionFree(game->engine);
+    memoryFree(game->live);
+    memoryFree(game);
 }
 
 
 char *wordleCheckGuess(Wordle *game, char *guess)
 {
     // Checking the correct length
-    if (strlen(guess) != WORD_LENGTH)
+    if (alphabetWordLength(guess) != WORD_LENGTH)
         return NULL;
 
-    // Filter function
-    int equals(void* a, void* b) {
-        return 0 == strcmp((char*)a, (char*)b);
-    }
+    if (game->engine)
+        return check_guess_adversarial(game, guess);
+
     // Checking the validity
-    if (0 == llFilter(game->guesses, equals, game->trueWord, 1, 0))
+    if (llFindString(game->guesses, guess) == NULL)
         return NULL;
 
     return wordleComputePattern(guess, game->trueWord);
@@ -168,62 +207,181 @@ char *wordleCheckGuess(Wordle *game, char *guess)
 
 
 char *wordleGetTrueWord(Wordle *game) {
+    if (game->engine)
+        return (char *)partitionAnswer(game->engine, game->live[0]);
+
     return game->trueWord;
 }
 
 
 char *wordleComputePattern(char *guess, char *answer)
 {
-    size_t answer_len = strlen(answer) + 1;
+    int code = wordlePatternCode(guess, answer);
+    if (code < 0)
+        return NULL;
 
-    // Se remplit des caractères de `answer` à chaque fois qu'une lettre correspondante a été identifiée
-    char completed[answer_len];
+    char* pattern = memoryAlloc(MEMORY_WORDLE, sizeof(char) * (WORD_LENGTH + 1));
+    if (pattern == NULL)
+        return NULL;
 
-    char* pattern = malloc(sizeof(char) * (answer_len));
+    wordlePatternToString(code, pattern);
 
-    size_t i, j;
+    return pattern;
+}
 
-    // initialisation
-    // Default pattern is '_____' and changes will be made where necesssary
-    for (i = 0; i < answer_len - 1; i++) {
-        pattern[i] = '_';
-        completed[i] = '\0';
+
+int wordlePatternCode(const char *guess, const char *answer)
+{
+    uint32_t points[2 * WORD_LENGTH];
+    unsigned char letters[2 * WORD_LENGTH];
+
+    if (alphabetDecode(guess, points, WORD_LENGTH) != WORD_LENGTH
+        || alphabetDecode(answer, points + WORD_LENGTH, WORD_LENGTH) != WORD_LENGTH)
+        return -1;
+
+    // Letters numbered in the order they are met, an alphabet of two words
+    for (int i = 0; i < 2 * WORD_LENGTH; i++) {
+        int j;
+        for (j = 0; j < i && points[j] != points[i]; j++)
+            ;
+        letters[i] = j < i ? letters[j] : (unsigned char)i;
     }
-    completed [answer_len - 1] = '\0'; pattern [answer_len - 1] = '\0';
-
-    for(i = 0; guess[i] != '\0'; i++) {
-        for (j = 0; answer[j] != '\0'; j++) {
-            if (guess[i] == answer[j]) {
-                if (i == j) {
-                    completed[i] = guess[i];
-                    pattern[i] = 'o';
-                    break;
-                }
-                else if (completed[j] == '\0'){
-                    if (guess[i] == answer[i]) {
-                        completed[i] = guess[i];
-                        pattern[i] = 'o';
-                        break;
-                    }
-
-                    if (answer[j] != guess[j]) {
-                        completed[j] = guess[i];
-                        pattern[i] = '*';
-                        break;
-                    }
-                }
-            }
+
+    return wordlePatternLetters(letters, letters + WORD_LENGTH);
+}
+
+
+int wordlePatternLetters(const unsigned char *guess,
+                         const unsigned char *answer)
+{
+    // Letters of `answer` not matched by a green, still available for a yellow
+    unsigned char remaining[ALPHABET_MAX_LETTERS] = {0};
+    int digits[WORD_LENGTH];
+    int i, code = 0;
+
+    for (i = 0; i < WORD_LENGTH; i++) {
+        if (guess[i] == answer[i])
+            digits[i] = 2;
+        else {
+            digits[i] = 0;
+            remaining[answer[i]]++;
+        }
+    }
+
+    for (i = WORD_LENGTH - 1; i >= 0; i--) {
+        code *= 3;
+        code += digits[i];
+    }
+
+    // Yellows are given from left to right while unmatched letters remain
+    for (i = 0; i < WORD_LENGTH; i++) {
+        if (digits[i] == 0 && remaining[guess[i]] > 0) {
+            remaining[guess[i]]--;
+            code += wordlePow3[i];
         }
     }
 
+    return code;
+}
+
+
+int wordlePatternFromString(const char *pattern)
+{
+    int code = 0;
+
+    if (strlen(pattern) != WORD_LENGTH)
+        return -1;
+
+    for (int i = WORD_LENGTH - 1; i >= 0; i--) {
+        code *= 3;
+        switch (pattern[i]) {
+            case '_': break;
+            case '*': code += 1; break;
+            case 'o': code += 2; break;
+            default: return -1;
+        }
+    }
+
+    return code;
+}
+
+
+void wordlePatternToString(int code, char *pattern)
+{
+    static const char symbols[3] = {'_', '*', 'o'};
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        pattern[i] = symbols[code % 3];
+        code /= 3;
+    }
+    pattern[WORD_LENGTH] = '\0';
+}
+
+
+/**
+ * @brief Answers a guess of an adversarial game with the pattern of the
+ * largest bucket of live answers, and keeps only that bucket alive.
+ */
+static char *check_guess_adversarial(Wordle *game, char *guess)
+{
+    int g = partitionFindGuess(game->engine, guess);
+    if (g < 0)
+        return NULL;
+
+    int histogram[PATTERN_COUNT];
+    partitionHistogram(game->engine, g, game->live, game->nlive, histogram);
+
+    // Largest bucket, conceding the win only when nothing else is left
+    int best = PATTERN_SOLVED;
+    for (int p = PATTERN_SOLVED - 1; p >= 0; p--)
+        if (histogram[p] > 0 && histogram[p] >= histogram[best])
+            best = p;
+
+    game->nlive = partitionSplit(game->engine, g, game->live, game->nlive, best);
+
+    char *pattern = memoryAlloc(MEMORY_WORDLE, (WORD_LENGTH + 1) * sizeof(char));
+    if (pattern == NULL)
+        return NULL;
+
+    wordlePatternToString(best, pattern);
     return pattern;
 }
 
 
+/**
+ * @brief Reads the next word of a word list, one per line. The end of line
+ * ('\n' or "\r\n") is dropped, and a line too long to be a word is
+ * truncated to WORD_BYTES - 1 bytes.
+ *
+ * @return 1 if a word was read, 0 at the end of the file.
+ */
+static int read_word(FILE *f, char *word)
+{
+    int c, length = 0;
+
+    while ((c = fgetc(f)) != EOF && c != '\n')
+        if (c != '\r' && length < WORD_BYTES - 1)
+            word[length++] = (char)c;
+    word[length] = '\0';
+
+    return c != EOF || length > 0;
+}
+
+
 static unsigned get_random(unsigned limit)
 {
-    srand(time(NULL));
-    return ((unsigned)((rand() % limit) + 1));
+    // Seeded once by main: reseeding here would give every game started
+    // within the same second the same word
+    return ((unsigned)(rand() % limit));
 }
 
 
+
+
+static void check_null_on_init_w(void *p)
+{
+    if (p == NULL) {
+        perror("Impossible de lancer le jeu:");
+        exit(EXIT_FAILURE);
+    }
+}
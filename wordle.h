@@ -2,7 +2,10 @@
 #define WORDLE_H
 
 
-#define WORD_LENGTH (5)
+#define WORD_LENGTH (5) // Letters of a word
+#define WORD_BYTES (4 * WORD_LENGTH + 1) // Buffer of a UTF-8 word and its '\0'
+#define PATTERN_COUNT (243) // 3^WORD_LENGTH patterns made of '_', '*' and 'o'
+#define PATTERN_SOLVED (PATTERN_COUNT - 1) // Code of the "ooooo" pattern
 #define DEBUG 1
 
 /**
@@ -21,6 +24,18 @@ typedef struct Wordle_t Wordle;
  */
 Wordle *wordleStart(char *answers_file, char *guesses_file, char *answer);
 
+/**
+ * @brief Starts an adversarial (Absurdle-style) wordle game. There is no
+ * fixed hidden word: each guess gets the pattern that keeps the most
+ * possible answers alive.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ *
+ * @return The game state.
+ */
+Wordle *wordleStartAdversarial(char *answers_file, char *guesses_file);
+
 /**
  * @brief Frees a given wordle game.
  *
@@ -35,7 +50,7 @@ void wordleFree(Wordle *game);
  * @param guess Word to guess.
  *
  * @return NULL if the guess is invalid, or the pattern
- * 		   obtained with this word otherwise.
+ * 		   obtained with this word otherwise, to free with memoryFree.
  */
 char *wordleCheckGuess(Wordle *game, char *guess);
 
@@ -44,7 +59,8 @@ char *wordleCheckGuess(Wordle *game, char *guess);
  *
  * @param game Game state.
  *
- * @return The true word to guess.
+ * @return The true word to guess. For an adversarial game, one of the
+ *         answers still consistent with every pattern given.
  */
 char *wordleGetTrueWord(Wordle *game);
 
@@ -55,9 +71,51 @@ char *wordleGetTrueWord(Wordle *game);
  * @param answer Word to guess.
  *
  * @return A pattern as string of 5 chars (+ the ending '\0'): '_' for
- *         grey, '*' for yellow, 'o' for green
- *
+ *         grey, '*' for yellow, 'o' for green, to free with
+ *         memoryFree.
  */
 char *wordleComputePattern(char *guess, char *answer);
 
+/**
+ * @brief Computes the pattern of a guess compared to the true word as an
+ * integer code in [0, PATTERN_COUNT). Position i contributes 3^i times 0 for
+ * grey, 1 for yellow and 2 for green.
+ *
+ * @param guess Word tried, in UTF-8.
+ * @param answer Word to guess, in UTF-8.
+ *
+ * @return The pattern code, or -1 if a word is not made of WORD_LENGTH
+ *         letters.
+ */
+int wordlePatternCode(const char *guess, const char *answer);
+
+/**
+ * @brief Computes the pattern code of a guess compared to the true word,
+ * both encoded as letter indices of an alphabet (see alphabet.h).
+ *
+ * @param guess WORD_LENGTH letter indices of the word tried.
+ * @param answer WORD_LENGTH letter indices of the word to guess.
+ *
+ * @return The pattern code.
+ */
+int wordlePatternLetters(const unsigned char *guess,
+                         const unsigned char *answer);
+
+/**
+ * @brief Converts a pattern string ('_', '*', 'o') to its integer code.
+ *
+ * @param pattern Pattern of WORD_LENGTH chars.
+ *
+ * @return The pattern code, or -1 if the string is not a valid pattern.
+ */
+int wordlePatternFromString(const char *pattern);
+
+/**
+ * @brief Writes the string form of a pattern code.
+ *
+ * @param code Pattern code.
+ * @param pattern Buffer of at least WORD_LENGTH + 1 chars.
+ */
+void wordlePatternToString(int code, char *pattern);
+
 #endif
@@ -0,0 +1,142 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "wordlists.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+
+/**
+ * @brief Modification time and size of a file, which tell it changed.
+ */
+typedef struct Version_t {
+    time_t seconds;
+    long nanoseconds;
+    off_t size;
+} Version;
+
+struct WordLists_t {
+    char *answersFile;
+    char *guessesFile;
+    Version answers; // Versions of the files last loaded
+    Version guesses;
+
+    // Only replaced by wordListsRefresh, under the lock so that a snapshot
+    // never gets an engine being released
+    Partition *current;
+    pthread_mutex_t lock;
+};
+
+
+static int readVersion(const char *file, Version *version);
+static int sameVersion(const Version *a, const Version *b);
+static void expectNotNull(void *p);
+
+
+WordLists *wordListsOpen(char *answers_file, char *guesses_file)
+{
+    WordLists *lists = memoryAlloc(MEMORY_WORDLISTS, sizeof(WordLists));
+    expectNotNull(lists);
+
+    lists->answersFile = answers_file;
+    lists->guessesFile = guesses_file;
+    readVersion(answers_file, &lists->answers);
+    readVersion(guesses_file, &lists->guesses);
+
+    lists->current = partitionCreate(answers_file, guesses_file);
+    partitionBuildIndex(lists->current);
+    pthread_mutex_init(&lists->lock, NULL);
+
+    return lists;
+}
+
+
+int wordListsRefresh(WordLists *lists, PartitionChanges *changes)
+{
+    Version answers, guesses;
+
+    // A file missing for a moment, while being replaced, is not a change
+    if (!readVersion(lists->answersFile, &answers)
+        || !readVersion(lists->guessesFile, &guesses)
+        || (sameVersion(&answers, &lists->answers)
+            && sameVersion(&guesses, &lists->guesses)))
+        return 0;
+
+    // Built aside: games go on with the current engine meanwhile
+    PartitionError error;
+    Partition *next = partitionReload(lists->current, lists->answersFile,
+                                      lists->guessesFile, changes, &error);
+
+    // Versions are recorded even on error, so that it is reported once
+    lists->answers = answers;
+    lists->guesses = guesses;
+
+    if (next == NULL) {
+        partitionReportError(&error, stderr);
+        fprintf(stderr, "Les listes de mots actuelles sont conservées.\n");
+        return 0;
+    }
+
+    pthread_mutex_lock(&lists->lock);
+    Partition *old = lists->current;
+    lists->current = next;
+    pthread_mutex_unlock(&lists->lock);
+
+    partitionFree(old);
+
+    return 1;
+}
+
+
+Partition *wordListsSnapshot(WordLists *lists)
+{
+    pthread_mutex_lock(&lists->lock);
+    Partition *p = partitionShare(lists->current);
+    pthread_mutex_unlock(&lists->lock);
+
+    return p;
+}
+
+
+void wordListsClose(WordLists *lists)
+{
+    partitionFree(lists->current);
+    pthread_mutex_destroy(&lists->lock);
+    memoryFree(lists);
+}
+
+
+/**
+ * @return 1 if the file could be read, 0 otherwise.
+ */
+static int readVersion(const char *file, Version *version)
+{
+    struct stat st;
+
+    if (stat(file, &st) != 0)
+        return 0;
+
+    version->seconds = st.st_mtim.tv_sec;
+    version->nanoseconds = st.st_mtim.tv_nsec;
+    version->size = st.st_size;
+
+    return 1;
+}
+
+
+static int sameVersion(const Version *a, const Version *b)
+{
+    return a->seconds == b->seconds && a->nanoseconds == b->nanoseconds
+        && a->size == b->size;
+}
+
+
+static void expectNotNull(void *p) {
+    if (p == NULL) {
+        perror("Une erreur est survenue :");
+        exit(EXIT_FAILURE);
+    }
+}
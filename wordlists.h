@@ -0,0 +1,60 @@
+#ifndef WORDLISTS_H
+#define WORDLISTS_H
+
+#include "partition.h"
+
+/**
+ * @brief Represents the word files of a long-running process, reloaded
+ * when they change.
+ *
+ * The engine of the current files is published as a snapshot: each game
+ * takes its own reference to the snapshot of the time it starts, and keeps
+ * it until it ends, even after a reload has published a newer one. A
+ * reload only computes the patterns of the words added (see
+ * partitionReload). Files should be replaced at once (by a rename): files
+ * that cannot be loaded, for instance read while half written, are
+ * reported and the current engine is kept.
+ */
+typedef struct WordLists_t WordLists;
+
+/**
+ * @brief Loads the word files and builds the tables of their engine.
+ *
+ * @param answers_file Path to the file containing the possible answers.
+ * @param guesses_file Path to the file containing the accepted words.
+ *
+ * @return The created word lists.
+ */
+WordLists *wordListsOpen(char *answers_file, char *guesses_file);
+
+/**
+ * @brief Reloads the word files if either was modified since the last
+ * load, and publishes the new engine. If the new files cannot be loaded,
+ * the error is printed on stderr and the current engine is kept; it is
+ * not printed again until the files change once more.
+ *
+ * @param lists The word lists.
+ * @param changes Filled with the words added and removed by the reload.
+ *
+ * @return 1 if the files were reloaded, 0 if they did not change or could
+ * not be loaded.
+ */
+int wordListsRefresh(WordLists *lists, PartitionChanges *changes);
+
+/**
+ * @brief Get the engine of the last load.
+ *
+ * @param lists The word lists.
+ *
+ * @return a new owner of the engine, to release with partitionFree.
+ */
+Partition *wordListsSnapshot(WordLists *lists);
+
+/**
+ * @brief Releases the last engine published and frees the word lists.
+ *
+ * @param lists The word lists.
+ */
+void wordListsClose(WordLists *lists);
+
+#endif